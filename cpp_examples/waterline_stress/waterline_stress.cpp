@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include <opencamlib/point.h>
+#include <opencamlib/stlsurf.h>
+#include <opencamlib/stlreader.h>
+#include <opencamlib/cylcutter.h>
+#include <opencamlib/waterline.h>
+
+// Runs many independent Waterline operations at the same time, one z-level per
+// OpenMP thread, and compares their loops with the same levels run one at a time.
+// Every concurrent job reads its own STLSurf, and every other job builds its weave
+// in strips with a TiledWeave.
+//
+// usage: waterline_stress file.stl [levels] [repeats]
+
+typedef std::vector< std::vector<ocl::Point> > Loops;
+
+// read the STL-file into s
+void read_stl(const std::string& filename, ocl::STLSurf& s) {
+    std::wstring wname( filename.begin(), filename.end() );
+    ocl::STLReader r( wname, s );
+}
+
+// the waterline loops of s at height z
+Loops waterline(const ocl::STLSurf& s, double z, bool tiled) {
+    double size = std::max( s.bb.maxpt.x - s.bb.minpt.x, s.bb.maxpt.y - s.bb.minpt.y );
+    ocl::CylCutter cutter( 0.02*size, 1000 );
+    ocl::Waterline w;
+    w.setSTL( s );
+    w.setCutter( &cutter );
+    w.setSampling( size/200 );
+    w.setZ( z );
+    w.setThreads( 1 ); // the jobs are the parallel work
+    if ( tiled )
+        w.setWeaveStrips( 3 );
+    w.run();
+    return w.getLoops();
+}
+
+bool same_loops(const Loops& a, const Loops& b) {
+    if ( a.size() != b.size() )
+        return false;
+    for (unsigned int n=0; n<a.size(); ++n) {
+        if ( a[n].size() != b[n].size() )
+            return false;
+        for (unsigned int m=0; m<a[n].size(); ++m) {
+            if ( !( a[n][m] == b[n][m] ) )
+                return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if ( argc < 2 ) {
+        std::cout << "usage: waterline_stress file.stl [levels] [repeats]\n";
+        return 1;
+    }
+    std::string filename( argv[1] );
+    int nlevels = ( argc > 2 ) ? atoi( argv[2] ) : 16;
+    int nrepeats = ( argc > 3 ) ? atoi( argv[3] ) : 4;
+    ocl::STLSurf surf;
+    read_stl( filename, surf );
+    std::vector<double> zlevels;
+    for (int n=0; n<nlevels; ++n)
+        zlevels.push_back( surf.bb.minpt.z + (n+0.5)/nlevels*( surf.bb.maxpt.z - surf.bb.minpt.z ) );
+
+    std::streambuf* out = std::cout.rdbuf( 0 ); // the operations are verbose
+    std::vector<Loops> serial( nlevels );
+    for (int n=0; n<nlevels; ++n)
+        serial[n] = waterline( surf, zlevels[n], false );
+
+    int njobs = nlevels*nrepeats;
+    std::vector<Loops> concurrent( njobs );
+    int n;
+    #pragma omp parallel for schedule(dynamic) private(n)
+    for (n=0; n<njobs; ++n) {
+        ocl::STLSurf s;
+        read_stl( filename, s );
+        concurrent[n] = waterline( s, zlevels[n % nlevels], (n % 2) == 1 );
+    }
+    std::cout.rdbuf( out );
+
+    int failed = 0;
+    for (n=0; n<njobs; ++n) {
+        if ( !same_loops( serial[n % nlevels], concurrent[n] ) ) {
+            std::cout << " job " << n << " at z=" << zlevels[n % nlevels] << " differs from the serial loops\n";
+            ++failed;
+        }
+    }
+    std::cout << njobs << " waterlines on " << omp_get_max_threads() << " threads, ";
+    std::cout << failed << " differ from the serial results\n";
+    return ( failed == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+import ocl
+import math
+import time
+
+# a path of a line, a half circle in the XY-plane, and a bump in the XZ-plane
+def test_path(step):
+    path=[]
+    x=0
+    while x<10:
+        path.append( ocl.CLPoint(x,0,1) )
+        x=x+step
+    a=-math.pi/2
+    while a<math.pi/2:
+        path.append( ocl.CLPoint(10+5*math.cos(a), 5+5*math.sin(a), 1) )
+        a=a+step/5
+    x=10
+    while x>0:
+        path.append( ocl.CLPoint(x,10,1) )
+        x=x-step
+    a=math.pi
+    while a>0:
+        path.append( ocl.CLPoint(-3+3*math.cos(a), 10, 1+3*math.sin(a)) )
+        a=a-step/3
+    return path
+
+# the coordinates of p in the plane of an arc, as in ArcCLFilter
+def to_plane(p, plane):
+    if plane == ocl.ArcPlane.XY:
+        return (p.x, p.y, p.z)
+    if plane == ocl.ArcPlane.XZ:
+        return (p.z, p.x, p.y)
+    return (p.y, p.z, p.x)
+
+def line_distance(a, b, p):
+    d = b-a
+    t = 0
+    if d.norm() > 0:
+        t = max(0, min(1, (p-a).dot(d)/d.dot(d) ))
+    return (a + t*d - p).norm()
+
+# the distance from p to the arc m, which starts at a
+def arc_distance(a, m, p):
+    (au, av, aw) = to_plane(a, m.plane)
+    (eu, ev, ew) = to_plane(m.end, m.plane)
+    (cu, cv, cw) = to_plane(m.center, m.plane)
+    (pu, pv, pw) = to_plane(p, m.plane)
+    sign = 1 if m.ccw else -1
+    start = math.atan2(av-cv, au-cu)
+    sweep = ( sign*( math.atan2(ev-cv, eu-cu) - start ) ) % (2*math.pi)
+    angle = ( sign*( math.atan2(pv-cv, pu-cu) - start ) ) % (2*math.pi)
+    if angle > sweep: # beyond an end of the arc
+        return min( (p-a).norm(), (p-m.end).norm() )
+    r = math.hypot(au-cu, av-cv)
+    return math.hypot( math.hypot(pu-cu, pv-cv) - r, pw-aw )
+
+# assert that the moves start at the first CL-point, end at CL-points of the path in order,
+# and that every CL-point dropped between them is within tol of the line or arc
+def check_moves(clpath, moves, tol):
+    path = [ ocl.Point(p.x, p.y, p.z) for p in clpath ]
+    assert len(moves) > 0 and (moves[0].end-path[0]).norm() == 0, "the first move is not to the first CL-point"
+    n = 0
+    for m in moves[1:]:
+        a = path[n]
+        n = n+1
+        while n < len(path) and (path[n]-m.end).norm() > 0:
+            if m.arc:
+                d = arc_distance(a, m, path[n])
+            else:
+                d = line_distance(a, m.end, path[n])
+            assert d <= tol*(1+1e-9), "CL-point %d is %g from its %s, tolerance %g" % (n, d, "arc" if m.arc else "line", tol)
+            n = n+1
+        assert n < len(path), "a move ends at a point not on the path"
+    assert n == len(path)-1, "the last move does not end at the last CL-point"
+
+if __name__ == "__main__":
+    print ocl.revision()
+    path = test_path(0.01)
+
+    f = ocl.ArcCLFilter()
+    f.setTolerance(0.001)
+    # the path is added in chunks, as a streaming operation would produce it
+    chunk=100
+    t_before = time.time()
+    for n in range(0,len(path),chunk):
+        f.addCLPoints( path[n:n+chunk] )
+    f.endPath()
+    moves = f.getMoves()
+    print len(path),"CL-points filtered to",len(moves),"moves in", time.time()-t_before," s"
+    for m in moves:
+        if m.arc:
+            print "arc ", m.plane, " ccw" if m.ccw else " cw ", " to ", m.end, " center ", m.center
+        else:
+            print "line to ", m.end
+    check_moves(path, moves, 0.001)
+
+    # independent paths are filtered in parallel
+    f.setThreads(4)
+    t_before = time.time()
+    out = f.filterPaths( [ path, path[::-1], test_path(0.02) ], False )
+    print len(out),"paths filtered in", time.time()-t_before," s, to",[len(moves) for moves in out],"moves"
+    check_moves(path, out[0], 0.001)
+    check_moves(path[::-1], out[1], 0.001)
+    check_moves(test_path(0.02), out[2], 0.001)
+    print "all dropped CL-points are within tolerance."
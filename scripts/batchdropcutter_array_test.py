@@ -0,0 +1,113 @@
+import ocl
+import time
+import numpy
+
+# the CL-points and the STL-surface are added from numpy arrays, and the list of CLPoint objects
+# from getCLPoints() is compared with the arrays from getCLPointArray() and getLoopArrays(),
+# which numpy reads without copying
+
+def pyramid():
+    s = ocl.STLSurf()
+    vertices = numpy.array( [ [0,0,0], [10,0,0], [10,10,0], [0,10,0], [5,5,4] ], dtype=float )
+    faces = numpy.array( [ [0,1,4], [1,2,4], [2,3,4], [3,0,4] ] )
+    s.addMesh( vertices, faces )
+    return s
+
+# True if f(*args) raises ValueError
+def raises(f, *args):
+    try:
+        f(*args)
+    except ValueError:
+        return True
+    return False
+
+if __name__ == "__main__":
+    print ocl.revision()
+    s = pyramid()
+    cutter = ocl.BallCutter(2,10)
+
+    bdc = ocl.BatchDropCutter()
+    bdc.setSTL(s)
+    bdc.setCutter(cutter)
+    n=500
+    x, y = numpy.meshgrid( numpy.linspace(-1,11,n), numpy.linspace(-1,11,n) )
+    grid = numpy.column_stack( [ x.ravel(), y.ravel(), numpy.repeat(-10.0, n*n) ] )
+    t_before = time.time()
+    bdc.appendPoints( grid )
+    print n*n, "CL-points added in", time.time()-t_before," s"
+    t_before = time.time()
+    bdc.run()
+    print n*n, "CL-points dropped in", time.time()-t_before," s"
+
+    t_before = time.time()
+    clpts = bdc.getCLPoints()
+    print "getCLPoints()    ", len(clpts), "CLPoint objects in", time.time()-t_before," s"
+    t_before = time.time()
+    cl = numpy.asarray( bdc.getCLPointArray() ) # columns x, y, z, cc-type
+    print "getCLPointArray()", cl.shape, "array in", time.time()-t_before," s"
+    print "max z", cl[:,2].max(), ",", (cl[:,3]==ocl.CCType.FACET).sum(), "FACET contacts"
+    assert cl.dtype == numpy.float64 and cl.shape == (len(clpts), 4) and cl.strides == (32, 8), \
+        "getCLPointArray() is %s %s with strides %s" % (cl.dtype, cl.shape, cl.strides)
+    ref = numpy.array( [ [p.x, p.y, p.z, int(p.cc().type)] for p in clpts ] )
+    assert (cl == ref).all(), "getCLPointArray() differs from getCLPoints() in %d rows" % (cl != ref).any(axis=1).sum()
+
+    empty = ocl.BatchDropCutter()
+    empty.setSTL(s)
+    empty.setCutter(cutter)
+    empty.run()
+    e = numpy.asarray( empty.getCLPointArray() )
+    assert e.shape == (0, 4) and len(empty.getCLPoints()) == 0, "getCLPointArray() without CL-points is %s" % (e.shape,)
+
+    wl = ocl.Waterline()
+    wl.setSTL(s)
+    wl.setCutter(cutter)
+    wl.setZ(1)
+    wl.setSampling(0.01)
+    wl.run()
+    offsets, xyz = wl.getLoopArrays()
+    offsets = numpy.asarray(offsets)
+    xyz = numpy.asarray(xyz)
+    loops = wl.getLoops()
+    assert offsets.shape == (len(loops)+1,) and xyz.shape == (offsets[-1], 3) and xyz.strides == (24, 8), \
+        "getLoopArrays() is %s and %s with strides %s" % (offsets.shape, xyz.shape, xyz.strides)
+    for k in range(len(loops)):
+        ref = numpy.array( [ [p.x, p.y, p.z] for p in loops[k] ] )
+        assert (xyz[ offsets[k]:offsets[k+1] ] == ref).all(), "getLoopArrays() differs from getLoops() in loop %d" % k
+    for k in range(len(offsets)-1):
+        loop = xyz[ offsets[k]:offsets[k+1] ]
+        print "loop", k, "with", len(loop), "points, x from", loop[:,0].min(), "to", loop[:,0].max()
+    print "the arrays match getCLPoints() and getLoops()."
+
+    # bad rows are rejected with ValueError, and nothing is appended
+    for bad in [ float('nan'), float('inf'), -float('inf') ]:
+        assert raises( bdc.appendPoints, numpy.array( [ [0,0,0], [1,bad,0] ] ) ), "appendPoints() accepts %s" % bad
+    assert len(bdc.getCLPoints()) == n*n, "appendPoints() appended points before raising"
+    bpc = ocl.BatchPushCutter()
+    bad_fibers = { "zero-length": [ [0,1,1], [0,1,1] ],
+                   "diagonal":    [ [0,0,1], [5,5,1] ],
+                   "sloping":     [ [0,1,1], [5,1,2] ],
+                   "nan":         [ [0,1,1], [float('nan'),1,1] ] }
+    for name, fiber in bad_fibers.items():
+        assert raises( bpc.appendFibers, numpy.array( [ [ [0,1,1], [5,1,1] ], fiber ] ) ), "appendFibers() accepts a %s fiber" % name
+    assert len(bpc.getFibers()) == 0, "appendFibers() appended fibers before raising"
+    bpc.appendFibers( numpy.array( [ [ [0,1,1], [5,1,1] ], [ [1,0,1], [1,5,1] ] ] ) )
+    assert len(bpc.getFibers()) == 2
+    print "NaN, infinite and bad fibers are rejected."
+
+    for bad in [ float('nan'), float('inf') ]:
+        assert raises( s.addTriangles, numpy.array( [ [ [0,0,0], [1,0,0], [bad,1,0] ] ] ) ), "addTriangles() accepts %s" % bad
+        assert raises( s.addMesh, numpy.array( [ [0,0,0], [1,0,0], [bad,1,0] ] ), numpy.array( [ [0,1,2] ] ) ), \
+            "addMesh() accepts %s" % bad
+    assert s.size() == 4 and s.getBounds() == [0, 10, 0, 10, 0, 4], "a non-finite triangle changed the surface"
+    print "NaN and infinite triangles are rejected."
+
+    path = ocl.Path()
+    bad_polylines = { "repeated": [ [0,0,0], [0,0,0], [0,1,0] ],
+                      "nan":      [ [0,0,0], [1,0,0], [float('nan'),1,0] ],
+                      "inf":      [ [0,0,0], [float('inf'),0,0] ] }
+    for name, polyline in bad_polylines.items():
+        assert raises( path.appendPolyline, numpy.array( polyline ) ), "appendPolyline() accepts a %s point" % name
+    assert len(path.getSpans()) == 0, "appendPolyline() appended lines before raising"
+    path.appendPolyline( numpy.array( [ [0,0,0], [1,0,0], [1,1,0] ] ) )
+    assert len(path.getSpans()) == 2
+    print "NaN, infinite and repeated polyline points are rejected."
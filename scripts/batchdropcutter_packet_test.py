@@ -0,0 +1,36 @@
+import ocl
+import pyocl
+import camvtk
+import time
+
+# compare kd-tree node visits and results of BatchDropCutter
+# with and without packet-search
+if __name__ == "__main__":  
+    print ocl.revision()
+    stl = camvtk.STLSurf("../stl/demo.stl")
+    polydata = stl.src.GetOutput()
+    s = ocl.STLSurf()
+    camvtk.vtkPolyData2OCLSTL(polydata, s)
+    print "STL surface read ", s.size(), " triangles"
+    cutter = ocl.BallCutter(2.0, 10)
+    print cutter
+    clpoints = pyocl.CLPointGrid(0, 0.05, 10, 0, 0.05, 10, -5)
+    print "generated grid with", len(clpoints)," CL-points"
+    
+    results = []
+    for packet in [1, 2, 4, 8, 16]:
+        bdc = ocl.BatchDropCutter()
+        bdc.setPacketSize(packet)
+        bdc.setSTL(s)
+        bdc.setCutter(cutter)
+        for p in clpoints:
+            bdc.appendPoint(p)
+        t_before = time.time()    
+        bdc.run()
+        calctime = time.time()-t_before
+        print "packet-size ", packet, " : ", bdc.getNodes(), " kd-tree nodes, ", bdc.getCalls(), " calls, ", calctime, " s"
+        results.append( [ p.z for p in bdc.getCLPoints() ] )
+    
+    for r in results[1:]:
+        assert( r == results[0] ) # packet-search must not change the result
+    print "all packet-sizes produce identical results."
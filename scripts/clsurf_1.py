@@ -68,7 +68,7 @@ if __name__ == "__main__":
     myscreen.camera.SetClippingRange(-2*camPos,2*camPos)
     myscreen.camera.SetFocalPoint(0.051, 0, 0)
     
-    cls = ocl.CutterLocationSurface(10)
+    cls = ocl.CutterLocationSurface()
     
     cutter = ocl.BallCutter(2,10)
     cls.setCutter(cutter)
@@ -76,6 +76,10 @@ if __name__ == "__main__":
     cls.setMinSampling(0.1)
     cls.setSTL(s)
     
+    t_before = time.time()
+    cls.run()
+    print "CL-surface:", len(cls.getVertices()), "vertices,", len(cls.getTriangles()), "triangles in", time.time()-t_before," s"
+    
     drawDiagram(myscreen, cls)
     #vd = ocl.VoronoiDiagram(far,1200)
     
@@ -0,0 +1,25 @@
+import ocl
+import time
+import math
+import random
+
+# LocalTSPSolver orders large point-sets, for which TSPSolver is too slow
+if __name__ == "__main__":
+    print ocl.revision()
+    random.seed(7)
+    for npts in [1000, 10000, 100000]:
+        tsp = ocl.LocalTSPSolver()
+        tsp.setTimeLimit(5)
+        tsp.setThreads(4)
+        for n in range(npts):
+            tsp.addPoint( 100*random.random(), 100*random.random() )
+        t_before = time.time()
+        tsp.run()
+        t_after = time.time()
+        out = tsp.getOutput()
+        # the expected length of an optimal tour of random points in a square
+        opt = 0.7124*100*math.sqrt(npts)
+        print npts," points, tour length ",tsp.getLength()," = ",tsp.getLength()/opt," x optimal, in ",t_after-t_before," s"
+        assert( len(out) == npts+1 and out[0] == out[-1] )
+        # every point is visited exactly once
+        assert( sorted(out[:-1]) == range(npts) )
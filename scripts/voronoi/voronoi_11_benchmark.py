@@ -0,0 +1,28 @@
+import ocl
+import time
+import math
+import random
+
+# time the insertion of random generators into a VoronoiDiagram
+
+def insert_time(N):
+    far = 1
+    vd = ocl.VoronoiDiagram( far, int( max(10, math.sqrt(N)) ) )
+    random.seed(42)
+    plist = []
+    for n in range(N):
+        r = 0.7*far*math.sqrt( random.random() )
+        a = 2*math.pi*random.random()
+        plist.append( ocl.Point( r*math.cos(a), r*math.sin(a) ) )
+    t_before = time.time()
+    for p in plist:
+        vd.addVertexSite( p )
+    t_after = time.time()
+    return t_after-t_before
+
+if __name__ == "__main__":
+    print ocl.revision()
+    for N in [1000, 4000, 16000]:
+        t = insert_time(N)
+        print " %6d generators in %.3f s,  %.2f us per generator" % (N, t, 1e6*t/N)
+    print "done."
@@ -0,0 +1,68 @@
+import ocl
+import camvtk
+import time
+import vtk
+import datetime
+import math
+
+def drawLoops(myscreen, loops, loopcolor):
+    for lop in loops:
+        for n in range(len(lop)):
+            p1 = lop[n]
+            p2 = lop[(n+1) % len(lop)] # the last point connects to the first point
+            myscreen.addActor( camvtk.Line(p1=(p1.x,p1.y,p1.z),p2=(p2.x,p2.y,p2.z),color=loopcolor) )
+
+def drawRapids(myscreen, start, loops, rapidcolor):
+    previous = start
+    for lop in loops:
+        p = lop[0] # each loop starts at its entry point
+        myscreen.addActor( camvtk.Line(p1=(previous.x,previous.y,previous.z),p2=(p.x,p.y,p.z),color=rapidcolor) )
+        previous = p
+
+if __name__ == "__main__":  
+    print ocl.revision()
+    myscreen = camvtk.VTKScreen()
+    stl = camvtk.STLSurf("../../stl/gnu_tux_mod.stl")
+    myscreen.addActor(stl)
+    stl.SetWireframe()
+    stl.SetColor(camvtk.cyan)
+    polydata = stl.src.GetOutput()
+    s = ocl.STLSurf()
+    camvtk.vtkPolyData2OCLSTL(polydata, s)
+    print "STL surface read,", s.size(), "triangles"
+    zmin = 0.2
+    zmax = 3.2
+    Nlevels = 16
+    cutter = ocl.BallCutter( 1.4 , 5 )
+    wl = ocl.MultiLevelWaterline()
+    wl.setSTL(s)
+    wl.setCutter(cutter)
+    wl.setSampling(0.1)
+    for n in range(Nlevels): # from the top down
+        wl.addLevel( zmax - n*(zmax-zmin)/(Nlevels-1) )
+    wl.run()
+    
+    start = ocl.Point(0,0,5)
+    seq = ocl.LoopSequencer()
+    seq.addLevels(wl)
+    seq.setStart(start)
+    t_before = time.time() 
+    seq.run()
+    print " level order: rapid moves ", seq.getTravel()," in ", time.time()-t_before," s"
+    seq.setIslandOrder(True)
+    t_before = time.time() 
+    seq.run()
+    print " island order: rapid moves ", seq.getTravel()," in ", time.time()-t_before," s"
+    for e in seq.getSequence():
+        print " level ",e.level," loop ",e.loop," entry point ",e.entry
+    loops = seq.getLoops()
+    drawLoops(myscreen, loops, camvtk.yellow)
+    drawRapids(myscreen, start, loops, camvtk.red)
+    
+    print "done."
+    myscreen.camera.SetPosition(15, 13, 7)
+    myscreen.camera.SetFocalPoint(5, 5, 0)
+    camvtk.drawArrows(myscreen,center=(-0.5,-0.5,-0.5))
+    camvtk.drawOCLtext(myscreen)
+    myscreen.render()    
+    myscreen.iren.Start()
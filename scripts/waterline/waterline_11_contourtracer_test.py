@@ -0,0 +1,42 @@
+import ocl
+
+# check that the ContourTracer, setContourTracing(True), finds the same loops as
+# Weave::face_traverse(), in the same order and with the same CL-points in the same order.
+# The TiledWeave, setWeaveStrips(n), is checked against the same loops.
+
+def waterline_loops(s, cutter, zh, sampling, tracing, strips=1):
+    wl = ocl.Waterline()
+    wl.setSTL(s)
+    wl.setCutter(cutter)
+    wl.setZ(zh)
+    wl.setSampling(sampling)
+    wl.setContourTracing(tracing)
+    wl.setWeaveStrips(strips)
+    wl.run()
+    return [ [ (p.x, p.y, p.z) for p in loop ] for loop in wl.getLoops() ]
+
+def check_same(name, weave, other):
+    assert len(other) == len(weave), "%s: %d loops, the weave has %d" % (name, len(other), len(weave))
+    for n in range(len(weave)):
+        assert len(other[n]) == len(weave[n]), "%s: loop %d has %d points, in the weave %d" % (name, n, len(other[n]), len(weave[n]))
+        assert other[n] == weave[n], "%s: the points of loop %d differ from the weave" % (name, n)
+
+if __name__ == "__main__":
+    print ocl.revision()
+    models = ["../../stl/demo.stl", "../../stl/30sphere.stl"]
+    for fname in models:
+        s = ocl.STLSurf()
+        ocl.STLReader(fname, s)
+        bb = s.getBounds()
+        size = max( bb[1]-bb[0], bb[3]-bb[2] )
+        cutters = [ ocl.CylCutter( 0.05*size, 1000 ), ocl.BallCutter( 0.05*size, 1000 ) ]
+        for cutter in cutters:
+            # at 0.3 of the height of demo.stl, the weave itself fails an assert in face_traverse()
+            for zfraction in [0.1, 0.4, 0.6, 0.9]:
+                zh = bb[4] + zfraction*(bb[5]-bb[4])
+                sampling = size/200
+                weave = waterline_loops(s, cutter, zh, sampling, False)
+                check_same("ContourTracer", weave, waterline_loops(s, cutter, zh, sampling, True))
+                check_same("TiledWeave", weave, waterline_loops(s, cutter, zh, sampling, False, 4))
+                print fname, cutter, "z=%.3f" % zh, len(weave), "loops", sum( [ len(loop) for loop in weave ] ), "points, same loops"
+    print "done."
@@ -0,0 +1,29 @@
+import ocl
+
+# a triangle entirely above the cutter-length doesn't touch the cutter, and is not pushed against.
+# Before the packet-search, the kd-tree search of each fiber also returned such triangles when they
+# shared a bucket with a triangle in the z-band [zh, zh+length], and pushing against them added intervals.
+# Since the packet-search, KDTree::overlaps() and the ZSlice z-band drop them, so a short
+# BullCutter on sphere.stl now gives 714 loops, where it used to give 770. With a cutter long
+# enough to reach the top of the sphere, no triangle is dropped and the two agree.
+
+def waterline_loops(s, cutter, zh, sampling):
+    wl = ocl.Waterline()
+    wl.setSTL(s)
+    wl.setCutter(cutter)
+    wl.setZ(zh)
+    wl.setSampling(sampling)
+    wl.run()
+    return wl.getLoops()
+
+if __name__ == "__main__":
+    print ocl.revision()
+    s = ocl.STLSurf()
+    ocl.STLReader("../../stl/sphere.stl", s)
+    cutter = ocl.BullCutter(2, 0.5, 6)
+    loops = waterline_loops(s, cutter, 0.3, 0.05)
+    npoints = sum( [ len(loop) for loop in loops ] )
+    print cutter, len(loops), "loops", npoints, "points"
+    assert len(loops) == 714 and npoints == 16842, \
+        "expected 714 loops and 16842 points, got %d loops and %d points" % (len(loops), npoints)
+    print "done."
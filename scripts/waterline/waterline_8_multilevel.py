@@ -0,0 +1,63 @@
+import ocl
+import camvtk
+import time
+import vtk
+import datetime
+import math
+
+def drawLoops(myscreen, loops, loopcolor):
+    for lop in loops:
+        n = 0
+        N = len(lop)
+        first_point=ocl.Point(-1,-1,5)
+        previous=ocl.Point(-1,-1,5)
+        for p in lop:
+            if n==0: # don't draw anything on the first iteration
+                previous=p 
+                first_point = p
+            elif n== (N-1): # the last point
+                myscreen.addActor( camvtk.Line(p1=(previous.x,previous.y,previous.z),p2=(p.x,p.y,p.z),color=loopcolor) ) # the normal line
+                # and a line from p to the first point
+                myscreen.addActor( camvtk.Line(p1=(p.x,p.y,p.z),p2=(first_point.x,first_point.y,first_point.z),color=loopcolor) )
+            else:
+                myscreen.addActor( camvtk.Line(p1=(previous.x,previous.y,previous.z),p2=(p.x,p.y,p.z),color=loopcolor) )
+                previous=p
+            n=n+1
+
+if __name__ == "__main__":  
+    print ocl.revision()
+    myscreen = camvtk.VTKScreen()
+    stl = camvtk.STLSurf("../../stl/gnu_tux_mod.stl")
+    myscreen.addActor(stl)
+    stl.SetWireframe()
+    stl.SetColor(camvtk.cyan)
+    polydata = stl.src.GetOutput()
+    s = ocl.STLSurf()
+    camvtk.vtkPolyData2OCLSTL(polydata, s)
+    print "STL surface read,", s.size(), "triangles"
+    zmin = 0.2
+    zmax = 3.2
+    Nlevels = 16
+    cutter = ocl.BallCutter( 1.4 , 5 )
+    wl = ocl.MultiLevelWaterline()
+    wl.setSTL(s) # the ZSlice of each level is built once, and shared by its X- and Y-fibers
+    wl.setCutter(cutter)
+    wl.setSampling(0.1)
+    for n in range(Nlevels):
+        wl.addLevel( zmin + n*(zmax-zmin)/(Nlevels-1) )
+    t_before = time.time() 
+    wl.run()
+    t_after = time.time()
+    print " MultiLevelWaterline with ", wl.getLevels()," levels done in ", t_after-t_before," s"
+    for n in range(wl.getLevels()):
+        loops = wl.getLoops(n)
+        print " level ",n," has ", len(loops)," loops"
+        drawLoops(myscreen, loops, camvtk.yellow)
+    
+    print "done."
+    myscreen.camera.SetPosition(15, 13, 7)
+    myscreen.camera.SetFocalPoint(5, 5, 0)
+    camvtk.drawArrows(myscreen,center=(-0.5,-0.5,-0.5))
+    camvtk.drawOCLtext(myscreen)
+    myscreen.render()    
+    myscreen.iren.Start()
@@ -0,0 +1,41 @@
+import ocl
+import time
+
+# time the weave-build of Waterline on some of the stl-models.
+# Waterline.run() does the push-cutter and then builds the weave-graph.
+# With setContourTracing(True) no graph is built, so the difference
+# between the two run-times is the time spent in the weave.
+# With setWeaveStrips(n) the weave is built in n strips on separate threads.
+
+def waterline_time(s, cutter, zh, sampling, tracing, strips=1):
+    wl = ocl.Waterline()
+    wl.setSTL(s)
+    wl.setCutter(cutter)
+    wl.setZ(zh)
+    wl.setSampling(sampling)
+    wl.setContourTracing(tracing)
+    wl.setWeaveStrips(strips)
+    t_before = time.time()
+    wl.run()
+    t_after = time.time()
+    return (t_after-t_before, len(wl.getLoops()))
+
+if __name__ == "__main__":
+    print ocl.revision()
+    models = ["../../stl/demo.stl", "../../stl/30sphere.stl", "../../stl/spider.stl"]
+    for fname in models:
+        s = ocl.STLSurf()
+        ocl.STLReader(fname, s)
+        bb = s.getBounds()
+        size = max( bb[1]-bb[0], bb[3]-bb[2] )
+        zh = bb[4] + 0.3*(bb[5]-bb[4])
+        cutter = ocl.CylCutter( 0.02*size, 1000 )
+        print fname, s.size(), "triangles"
+        for n in [400, 1000]:
+            sampling = size/n
+            (t_weave, nloops) = waterline_time(s, cutter, zh, sampling, False)
+            (t_trace, nloops2) = waterline_time(s, cutter, zh, sampling, True)
+            (t_tiled, nloops3) = waterline_time(s, cutter, zh, sampling, False, 4)
+            print " sampling= %.4f  %d loops  weave %.3f s  tracing %.3f s  weave-build %.3f s" % (sampling, nloops, t_weave, t_trace, t_weave-t_trace)
+            print "   4 strips: %d loops  weave-build %.3f s" % (nloops3, t_tiled-t_trace)
+    print "done."
@@ -28,9 +28,12 @@ def DrawLoops(myscreen, loops):
         print "rendered loop ",nloop, " with ", len(lop), " points"
         nloop = nloop+1
 
-def drawOutput(myscreen, pts, stepOver):
-    for p in pts:
-        myscreen.addActor( camvtk.Sphere(center=(p.x,p.y,p.z), radius=stepOver/5, color=camvtk.red) )
+def drawOutput(myscreen, paths):
+    for path in paths:
+        for n in range(len(path)-1):
+            p1 = path[n]
+            p2 = path[n+1]
+            myscreen.addActor( camvtk.Line(p1=(p1.x,p1.y,p1.z),p2=(p2.x,p2.y,p2.z),color=camvtk.red) )
 
 if __name__ == "__main__":  
     print ocl.revision()
@@ -80,13 +83,12 @@ if __name__ == "__main__":
     stepOver = 0.021
     z.setStepOver( stepOver )
     for lop in loops:
-        for p in lop:
-            z.addPoint(p)
+        z.addPolygon(lop) # the pocket is inside an odd number of loops
     z.run()
     print z
     out = z.getOutput()
-    print "got ",len(out)," output points"
-    drawOutput(myscreen, out, stepOver )
+    print "got ",len(out)," zigzag paths"
+    drawOutput(myscreen, out )
     
     print "done."
     myscreen.camera.SetPosition(2, 2, 2)
@@ -0,0 +1,73 @@
+import ocl
+import math
+
+# checks of the ZigZag paths: every cut and every move between two scanlines stays inside the pocket,
+# and the scanlines on the bottom and top edge of the pocket are both kept
+
+# True if (x,y) is inside an odd number of polygons, or within eps of an edge
+def inside(polygons, x, y, eps=1e-9):
+    n = 0
+    for poly in polygons:
+        for i in range(len(poly)):
+            a = poly[i-1]
+            b = poly[i]
+            dx = b.x-a.x
+            dy = b.y-a.y
+            t = max(0, min(1, ( (x-a.x)*dx + (y-a.y)*dy ) / (dx*dx + dy*dy) ))
+            if (a.x + t*dx - x)**2 + (a.y + t*dy - y)**2 <= eps*eps:
+                return True
+            if (a.y > y) != (b.y > y) and x < a.x + dx*(y-a.y)/dy:
+                n = n+1
+    return n % 2 == 1
+
+def zigzag(polygons, origin, direction, stepOver):
+    z = ocl.ZigZag()
+    z.setOrigin(origin)
+    z.setDirection(direction)
+    z.setStepOver(stepOver)
+    for poly in polygons:
+        z.addPolygon(poly)
+    z.run()
+    return z.getOutput()
+
+def check_inside(name, polygons, paths):
+    for path in paths:
+        for n in range(len(path)-1):
+            a = path[n]
+            b = path[n+1]
+            for k in range(1,20):
+                f = k/20.0
+                x = a.x + f*(b.x-a.x)
+                y = a.y + f*(b.y-a.y)
+                assert inside(polygons, x, y), "%s: the move from %s to %s leaves the pocket at (%g, %g)" % (name, a, b, x, y)
+
+def polygon(xy):
+    return [ ocl.Point(x, y, 0) for (x, y) in xy ]
+
+if __name__ == "__main__":
+    print ocl.revision()
+
+    # an L-shaped pocket. the end of the first scanline, at x=10, must not link to the second
+    # scanline, which ends at x=3, across the inside corner
+    L = [ polygon( [(0,0), (10,0), (10,0.6), (3,0.6), (3,3), (0,3)] ) ]
+    paths = zigzag(L, ocl.Point(0,0.5), ocl.Point(1,0), 1)
+    check_inside("L-pocket", L, paths)
+    assert len(paths) == 2, "L-pocket: %d paths, expected 2" % len(paths)
+    print "L-pocket:", len(paths), "paths"
+
+    # a rectangle, with scanlines on its bottom and top edge
+    rect = [ polygon( [(0,0), (10,0), (10,3), (0,3)] ) ]
+    paths = zigzag(rect, ocl.Point(0,0), ocl.Point(1,0), 1)
+    check_inside("rectangle", rect, paths)
+    ys = sorted( set( [ p.y for path in paths for p in path ] ) )
+    assert ys == [0, 1, 2, 3], "rectangle: scanlines at y=%s, expected 0, 1, 2, 3" % ys
+    assert len(paths) == 1, "rectangle: %d paths, expected 1" % len(paths)
+    print "rectangle:", len(paths), "path on scanlines", ys
+
+    # a star with a square island, at an angle
+    star = [ polygon( [ ( (10 if k%2==0 else 5)*math.cos(math.pi*k/8), (10 if k%2==0 else 5)*math.sin(math.pi*k/8) ) for k in range(16) ] ),
+             polygon( [(-2,-2), (2,-2), (2,2), (-2,2)] ) ]
+    paths = zigzag(star, ocl.Point(0.01,0.02), ocl.Point(1,0.3), 0.37)
+    check_inside("star", star, paths)
+    print "star:", len(paths), "paths"
+    print "done."
@@ -54,12 +54,11 @@ AdaptiveWaterline::AdaptiveWaterline() {
     nthreads=1;
 #ifdef _OPENMP
     nthreads = omp_get_num_procs(); 
-    //omp_set_dynamic(0);
-    omp_set_nested(1);
 #endif
     sampling = 1.0;
     min_sampling = 0.1;
     cosLimit = 0.999;
+    taskDepth = 6;
 }
 
 AdaptiveWaterline::~AdaptiveWaterline() {
@@ -83,6 +82,10 @@ void AdaptiveWaterline::run() {
     weave2_process();
 }
 
+// the X and Y passes are independent, so they run as two OpenMP tasks, and 
+// the subdivision below them creates more tasks. Each task writes its fibers
+// to a separate vector, and these are joined in increasing coordinate order,
+// so the result is identical to a serial run.
 void AdaptiveWaterline::adaptive_sampling_run() {
     minx = surf->bb.minpt.x - 2*cutter->getRadius();
     maxx = surf->bb.maxpt.x + 2*cutter->getRadius();
@@ -92,30 +95,40 @@ void AdaptiveWaterline::adaptive_sampling_run() {
     Span* linespan = new LineSpan(*line);
     
     xfibers.clear();
-    Point xstart_p1 = Point( minx, linespan->getPoint(0.0).y,  zh );
-    Point xstart_p2 = Point( maxx, linespan->getPoint(0.0).y,  zh );
-    Point xstop_p1 = Point( minx, linespan->getPoint(1.0).y,  zh );
-    Point xstop_p2 = Point( maxx, linespan->getPoint(1.0).y,  zh );
-    Fiber xstart_f = Fiber( xstart_p1, xstart_p2 ) ;
-    Fiber xstop_f = Fiber( xstop_p1, xstop_p2 ); 
-    subOp[0]->run(xstart_f);
-    subOp[0]->run(xstop_f);
-    xfibers.push_back(xstart_f);
-    std::cout << " XFiber adaptive sample \n";
-    xfiber_adaptive_sample( linespan, 0.0, 1.0, xstart_f, xstop_f);
-    
     yfibers.clear();
-    Point ystart_p1 = Point( linespan->getPoint(0.0).x, miny,  zh );
-    Point ystart_p2 = Point( linespan->getPoint(0.0).x, maxy,  zh );
-    Point ystop_p1 = Point( linespan->getPoint(1.0).x, miny,  zh );
-    Point ystop_p2 = Point( linespan->getPoint(1.0).x, maxy,  zh );
-    Fiber ystart_f = Fiber( ystart_p1, ystart_p2 ) ;
-    Fiber ystop_f = Fiber( ystop_p1, ystop_p2 ); 
-    subOp[1]->run(ystart_f);
-    subOp[1]->run(ystop_f);
-    yfibers.push_back(ystart_f);
-    std::cout << " YFiber adaptive sample \n";
-    yfiber_adaptive_sample( linespan, 0.0, 1.0, ystart_f, ystop_f);
+    #pragma omp parallel num_threads(nthreads) shared(linespan)
+    {
+        #pragma omp single
+        {
+            #pragma omp task shared(linespan)
+            {
+                Point xstart_p1 = Point( minx, linespan->getPoint(0.0).y,  zh );
+                Point xstart_p2 = Point( maxx, linespan->getPoint(0.0).y,  zh );
+                Point xstop_p1 = Point( minx, linespan->getPoint(1.0).y,  zh );
+                Point xstop_p2 = Point( maxx, linespan->getPoint(1.0).y,  zh );
+                Fiber xstart_f = Fiber( xstart_p1, xstart_p2 ) ;
+                Fiber xstop_f = Fiber( xstop_p1, xstop_p2 ); 
+                subOp[0]->run(xstart_f);
+                subOp[0]->run(xstop_f);
+                xfibers.push_back(xstart_f);
+                xfiber_adaptive_sample( linespan, 0.0, 1.0, xstart_f, xstop_f, xfibers, 0);
+            }
+            #pragma omp task shared(linespan)
+            {
+                Point ystart_p1 = Point( linespan->getPoint(0.0).x, miny,  zh );
+                Point ystart_p2 = Point( linespan->getPoint(0.0).x, maxy,  zh );
+                Point ystop_p1 = Point( linespan->getPoint(1.0).x, miny,  zh );
+                Point ystop_p2 = Point( linespan->getPoint(1.0).x, maxy,  zh );
+                Fiber ystart_f = Fiber( ystart_p1, ystart_p2 ) ;
+                Fiber ystop_f = Fiber( ystop_p1, ystop_p2 ); 
+                subOp[1]->run(ystart_f);
+                subOp[1]->run(ystop_f);
+                yfibers.push_back(ystart_f);
+                yfiber_adaptive_sample( linespan, 0.0, 1.0, ystart_f, ystop_f, yfibers, 0);
+            }
+        } // implicit barrier, all tasks are done here
+    }
+    std::cout << " adaptive sample: " << xfibers.size() << " X-fibers, " << yfibers.size() << " Y-fibers\n";
     
     delete line;
     delete linespan;
@@ -123,7 +136,8 @@ void AdaptiveWaterline::adaptive_sampling_run() {
 }
 
 
-void AdaptiveWaterline::xfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f) {
+void AdaptiveWaterline::xfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f, 
+                                               std::vector<Fiber>& out, int depth) {
     const double mid_t = start_t + (stop_t-start_t)/2.0; // mid point sample
     assert( mid_t > start_t );  assert( mid_t < stop_t );
     //std::cout << "xfiber sample= ( " << start_t << " , " << stop_t << " ) \n";
@@ -132,20 +146,35 @@ void AdaptiveWaterline::xfiber_adaptive_sample(const Span* span, double start_t,
     Fiber mid_f = Fiber( mid_p1, mid_p2 );
     subOp[0]->run( mid_f );
     double fw_step = fabs( start_f.p1.y - stop_f.p1.y ) ;
+    bool subdivide = false;
     if ( fw_step > sampling ) { // above minimum step-forward, need to sample more
-        xfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f  );
-        xfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f );
+        subdivide = true;
     } else if ( !flat(start_f,mid_f,stop_f)   ) {
-        if (fw_step > min_sampling) { // not a a flat segment, and we have not reached maximum sampling
-            xfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f  );
-            xfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f );
-        }
+        if (fw_step > min_sampling) // not a a flat segment, and we have not reached maximum sampling
+            subdivide = true;
     } else {
-        xfibers.push_back(stop_f);
+        out.push_back(stop_f);
     } 
+    if ( subdivide ) {
+        if ( depth < taskDepth ) { // sample the two halves in parallel
+            std::vector<Fiber> lo_out;
+            std::vector<Fiber> hi_out;
+            #pragma omp task shared(lo_out)
+            xfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f, lo_out, depth+1 );
+            #pragma omp task shared(hi_out)
+            xfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f, hi_out, depth+1 );
+            #pragma omp taskwait
+            out.insert( out.end(), lo_out.begin(), lo_out.end() );
+            out.insert( out.end(), hi_out.begin(), hi_out.end() );
+        } else {
+            xfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f, out, depth+1 );
+            xfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f, out, depth+1 );
+        }
+    }
 }
 
-void AdaptiveWaterline::yfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f) {
+void AdaptiveWaterline::yfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f, 
+                                               std::vector<Fiber>& out, int depth) {
     const double mid_t = start_t + (stop_t-start_t)/2.0; // mid point sample
     assert( mid_t > start_t );  assert( mid_t < stop_t );
     //std::cout << "yfiber sample= ( " << start_t << " , " << stop_t << " ) \n";
@@ -154,16 +183,30 @@ void AdaptiveWaterline::yfiber_adaptive_sample(const Span* span, double start_t,
     Fiber mid_f = Fiber( mid_p1, mid_p2 );
     subOp[1]->run( mid_f );
     double fw_step = fabs( start_f.p1.x - stop_f.p1.x ) ;
+    bool subdivide = false;
     if ( fw_step > sampling ) { // above minimum step-forward, need to sample more
-        yfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f  );
-        yfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f );
+        subdivide = true;
     } else if ( !flat(start_f,mid_f,stop_f)   ) {
-        if (fw_step > min_sampling) { // not a a flat segment, and we have not reached maximum sampling
-            yfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f  );
-            yfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f );
-        }
+        if (fw_step > min_sampling) // not a a flat segment, and we have not reached maximum sampling
+            subdivide = true;
     } else {
-        yfibers.push_back(stop_f); 
+        out.push_back(stop_f);
+    } 
+    if ( subdivide ) {
+        if ( depth < taskDepth ) { // sample the two halves in parallel
+            std::vector<Fiber> lo_out;
+            std::vector<Fiber> hi_out;
+            #pragma omp task shared(lo_out)
+            yfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f, lo_out, depth+1 );
+            #pragma omp task shared(hi_out)
+            yfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f, hi_out, depth+1 );
+            #pragma omp taskwait
+            out.insert( out.end(), lo_out.begin(), lo_out.end() );
+            out.insert( out.end(), hi_out.begin(), hi_out.end() );
+        } else {
+            yfiber_adaptive_sample( span, start_t, mid_t , start_f, mid_f, out, depth+1 );
+            yfiber_adaptive_sample( span, mid_t  , stop_t, mid_f  , stop_f, out, depth+1 );
+        }
     }
 }
 
@@ -64,10 +64,13 @@ class AdaptiveWaterline : public Waterline {
     protected:
         /// adaptive waterline algorithm
         void adaptive_sampling_run();
-        /// x-direction adaptive sampling
-        void xfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f);
-        /// y-direction adaptive sampling
-        void yfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f);
+        /// x-direction adaptive sampling. the sampled fibers are appended to out. 
+        /// Above taskDepth levels of recursion the two halves run as separate OpenMP tasks.
+        void xfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f, 
+                                    std::vector<Fiber>& out, int depth);
+        /// y-direction adaptive sampling, see xfiber_adaptive_sample()
+        void yfiber_adaptive_sample(const Span* span, double start_t, double stop_t, Fiber start_f, Fiber stop_f, 
+                                    std::vector<Fiber>& out, int depth);
         /// flatness predicate for fibers. Checks Fiber.size() and then calls flat() on cl-points
         bool flat( Fiber& start, Fiber& mid, Fiber& stop ) const;
         /// flatness predicate for cl-points. checks for angle metween start-mid-stop
@@ -87,6 +90,8 @@ class AdaptiveWaterline : public Waterline {
         double min_sampling;
         /// the cosine limit value for cl-point flat(). In the constructor, cosLimit = 0.999 by default.
         double cosLimit;
+        /// recursion depth below which the fiber adaptive sampling no longer creates new tasks
+        int taskDepth;
 };
 
 } // end namespace
@@ -23,6 +23,7 @@
 
 #include "adaptivewaterline.h"
 #include "fiber_py.h"
+#include "array_py.h"
 
 namespace ocl
 {
@@ -47,6 +48,10 @@ class AdaptiveWaterline_py : public AdaptiveWaterline {
             }
             return loop_list;
         }
+        /// return the loops to python as Arrays, see loop_arrays()
+        boost::python::tuple getLoopArrays() const {
+            return loop_arrays( loops );
+        }
         /// return a list of xfibers to python
         boost::python::list getXFibers() const {
             boost::python::list flist;
@@ -18,6 +18,9 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cmath>
+
 #include <boost/foreach.hpp>
 #include <boost/progress.hpp>
 
@@ -29,6 +32,7 @@
 #include "point.h"
 #include "triangle.h"
 #include "batchpushcutter.h"
+#include "zslice.h"
 //#include "kdtree.h"
 
 namespace ocl
@@ -45,7 +49,11 @@ BatchPushCutter::BatchPushCutter() {
 #endif
     cutter = NULL;
     bucketSize = 1;
+    packetSize = 8;
+    segmentLength = 0.0;
+    slices = NULL;
     root = new KDTree<Triangle>();
+    treeBuilt = false;
 }
 
 BatchPushCutter::~BatchPushCutter() {
@@ -55,19 +63,30 @@ BatchPushCutter::~BatchPushCutter() {
 
 void BatchPushCutter::setSTL(const STLSurf &s) {
     surf = &s;
-    std::cout << "BPC::setSTL() Building kd-tree... bucketSize=" << bucketSize << "..";
+    treeBuilt = false;
+}
+
+// the tree is built on the first search, so a Waterline, which pushes against its ZSlices,
+// never builds it. The dimensions follow segmentLength and the direction at that time.
+void BatchPushCutter::build_tree() {
+    if ( treeBuilt )
+        return;
+    std::cout << "BPC::build_tree() Building kd-tree... bucketSize=" << bucketSize << "..";
     root->setBucketSize( bucketSize );
-    if (x_direction)
+    if (segmentLength > 0.0)
+        root->setXYZDimensions(); // segments are searched also along the fiber
+    else if (x_direction)
         root->setYZDimensions(); // we search for triangles in the XY plane, don't care about Z-coordinate
     else if (y_direction)
         root->setXZDimensions();
     else {
-        std::cout << " ERROR: setXDirection() or setYDirection() must be called before setSTL() \n";
+        std::cout << " ERROR: setXDirection() or setYDirection() must be called before run() \n";
         assert(0);
     }
-    std::cout << "BPC::setSTL() root->build()\n";
-    root->build(s.tris);
+    std::cout << "BPC::build_tree() root->build()\n";
+    root->build(surf->tris);
     std::cout << "BPC:: root->build() done.\n";
+    treeBuilt = true;
 }
 
 void BatchPushCutter::appendFiber(Fiber& f) {
@@ -100,6 +119,7 @@ void BatchPushCutter::pushCutter2() {
     std::cout << "BatchPushCutter2 with " << fibers->size() << 
               " fibers and " << surf->tris.size() << " triangles..." << std::endl;
     nCalls = 0;
+    build_tree();
     std::list<Triangle>* overlap_triangles;
     boost::progress_display show_progress( fibers->size() );
     BOOST_FOREACH(Fiber& f, *fibers) {
@@ -139,20 +159,16 @@ void BatchPushCutter::pushCutter3() {
               " fibers and " << surf->tris.size() << " triangles." << std::endl;
     std::cout << " cutter = " << cutter->str() << "\n";
     nCalls = 0;
+    build_tree();
     boost::progress_display show_progress( fibers->size() );
-#ifdef _OPENMP
-    omp_set_num_threads(nthreads);
-    //omp_set_nested(1);
-#endif
     unsigned int Nmax = fibers->size();         // the number of fibers to process
     std::list<Triangle>::iterator it,it_end;    // for looping over found triabgles
-    Interval* i;
     std::list<Triangle>* tris;
     std::vector<Fiber>& fiberr = *fibers;
     unsigned int n; // loop variable
     unsigned int calls=0;
     
-    #pragma omp parallel for schedule(dynamic) shared(calls, fiberr) private(n,i,tris,it,it_end)
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared(calls, fiberr) private(n,tris,it,it_end)
     //#pragma omp parallel for shared( calls, fiberr) private(n,i,tris,it,it_end)
     for (n=0; n<Nmax; ++n) {
 #ifdef _OPENMP
@@ -176,11 +192,10 @@ void BatchPushCutter::pushCutter3() {
         for ( it=tris->begin() ; it!=it_end ; ++it) {
             //if ( bb->overlaps( it->bb ) ) {
                 // todo: optimization where method-calls are skipped if triangle bbox already in the fiber
-                i = new Interval();
-                cutter->pushCutter(fiberr[n],*i,*it);  
-                fiberr[n].addInterval(*i); 
+                Interval i;
+                cutter->pushCutter(fiberr[n],i,*it);  
+                fiberr[n].addInterval(i); 
                 ++calls;
-                delete i;
             //}
         }
         delete( tris );
@@ -192,5 +207,249 @@ void BatchPushCutter::pushCutter3() {
     return;
 }
 
+// the search is in the YZ-plane for X-fibers and in the XZ-plane for Y-fibers,
+// so the coordinate along the fiber is set to zero.
+CLPoint BatchPushCutter::search_point(const Fiber& f) const {
+    CLPoint cl;
+    if ( x_direction ) {
+        cl.x=0;
+        cl.y=f.p1.y;
+        cl.z=f.p1.z;
+    } else if (y_direction ) {
+        cl.x=f.p1.x;
+        cl.y=0;
+        cl.z=f.p1.z;
+    } else {
+        assert(0);
+    }
+    return cl;
+}
+
+// the cutter bounding-box at both ends of the fiber-segment.
+// without segments the kd-tree doesn't search along the fiber, so this box
+// is then used only in the two other dimensions.
+Bbox BatchPushCutter::fiber_bbox(const Fiber& f, double t0, double t1) const {
+    CLPoint cl0( f.point(t0) );
+    CLPoint cl1( f.point(t1) );
+    Bbox bb = KDTree<Triangle>::cutter_bbox( cutter, &cl0 );
+    Bbox bb1 = KDTree<Triangle>::cutter_bbox( cutter, &cl1 );
+    bb.addPoint( bb1.minpt );
+    bb.addPoint( bb1.maxpt );
+    return bb;
+}
+
+// the cutter touches bb only when its center is within one radius of bb along the fiber
+bool BatchPushCutter::covered(const Fiber& f, const Bbox& bb) const {
+    if ( f.empty() )
+        return false;
+    double r = cutter->getRadius();
+    double t0, t1;
+    if ( x_direction ) {
+        t0 = ( bb.minpt.x - r - f.p1.x ) / ( f.p2.x - f.p1.x );
+        t1 = ( bb.maxpt.x + r - f.p1.x ) / ( f.p2.x - f.p1.x );
+    } else {
+        t0 = ( bb.minpt.y - r - f.p1.y ) / ( f.p2.y - f.p1.y );
+        t1 = ( bb.maxpt.y + r - f.p1.y ) / ( f.p2.y - f.p1.y );
+    }
+    if ( t0 > t1 )
+        std::swap( t0, t1 );
+    return f.covers( t0, t1 );
+}
+
+// a packet is a run of consecutive fibers that all lie within one cutter-diameter
+// from the first fiber of the packet, and within one cutter-length in z.
+// with slices, the fibers of a packet have the same z-height, so that the packet
+// is pushed against one ZSlice, with one search of its kd-tree.
+// with segments, a packet holds fibers no longer than one segment, with their 
+// mid-points at most one segment-length from the first fiber. Longer fibers are 
+// packets of their own, and are searched in segments by push_segments().
+std::vector<unsigned int> BatchPushCutter::build_packets() const {
+    std::vector<unsigned int> packets;
+    const std::vector<Fiber>& fiberr = *fibers;
+    unsigned int n = 0;
+    while ( n < fiberr.size() ) {
+        packets.push_back(n);
+        unsigned int first = n;
+        ++n;
+        if ( segmentLength > 0.0 ) {
+            if ( (fiberr[first].p2-fiberr[first].p1).norm() > segmentLength )
+                continue;
+            while ( (n < fiberr.size()) && 
+                    (n-first < packetSize) && 
+                    ( (fiberr[n].p2-fiberr[n].p1).norm() <= segmentLength ) &&
+                    same_level( fiberr[n], fiberr[first] ) && 
+                    (fiberr[n].point(0.5).xyDistance( fiberr[first].point(0.5) ) <= segmentLength ) ) {
+                ++n;
+            }
+        } else {
+            while ( (n < fiberr.size()) && 
+                    (n-first < packetSize) && 
+                    same_level( fiberr[n], fiberr[first] ) && 
+                    (search_point(fiberr[n]).xyDistance( search_point(fiberr[first]) ) <= cutter->getDiameter() ) ) {
+                ++n;
+            }
+        }
+    }
+    packets.push_back( fiberr.size() );
+    return packets;
+}
+
+/// packet version of pushCutter3()
+/// one kd-tree search with the union bounding-box of the packet, then
+/// KDTree::overlaps() selects the triangles for each fiber in the packet
+void BatchPushCutter::pushCutter4() {
+    std::cout << "BatchPushCutter4 with " << fibers->size() << 
+              " fibers and " << surf->tris.size() << " triangles." << std::endl;
+    std::cout << " cutter = " << cutter->str() << "\n";
+    std::vector<BatchPushCutter*> batches(1, this);
+    runBatches( batches, nthreads );
+    std::cout << "\nBatchPushCutter4 done. ";
+    std::cout << nNodes << " kd-tree nodes visited." << std::endl;
+    return;
+}
+
+bool BatchPushCutter::same_level(const Fiber& f1, const Fiber& f2) const {
+    if ( slices )
+        return f1.p1.z == f2.p1.z;
+    return fabs( f1.p1.z - f2.p1.z ) <= cutter->getLength();
+}
+
+static bool slice_below(const ZSlice* slice, double z) {
+    return slice->getZ() < z;
+}
+
+// with slices, the packet is at one z-height, and its ZSlice is found by
+// binary search in the slices, which are sorted by z-height.
+int BatchPushCutter::push_packet(unsigned int first, unsigned int last, unsigned long& nodes) {
+    std::vector<unsigned int> idx;
+    for (unsigned int n=first; n<last; ++n)
+        idx.push_back( n );
+    if ( !slices )
+        return push_indexed( idx, root, nodes );
+    double z = (*fibers)[first].p1.z;
+    std::vector<ZSlice*>::const_iterator it = std::lower_bound( slices->begin(), slices->end(), z, slice_below );
+    assert( (it != slices->end()) && ((*it)->getZ() == z) ); // every fiber lies at the z-height of a slice
+    if ( (it == slices->end()) || ((*it)->getZ() != z) || !(*it)->getTree() ) 
+        return 0; // an empty slice has nothing to push against
+    return push_indexed( idx, (*it)->getTree(), nodes );
+}
+
+template <class T> 
+int BatchPushCutter::push_indexed(const std::vector<unsigned int>& idx, KDTree<T>* tree, unsigned long& nodes) {
+    std::vector<Fiber>& fiberr = *fibers;
+    if ( (segmentLength > 0.0) && ( (fiberr[idx[0]].p2-fiberr[idx[0]].p1).norm() > segmentLength ) ) {
+        assert( idx.size() == 1 ); // long fibers are alone in their packet
+        return push_segments( fiberr[idx[0]], tree, nodes );
+    }
+    Bbox bb;
+    BOOST_FOREACH( unsigned int n, idx ) { // union of cutter bounding-boxes
+        Bbox f_bb = fiber_bbox( fiberr[n], 0.0, 1.0 );
+        bb.addPoint( f_bb.minpt );
+        bb.addPoint( f_bb.maxpt );
+    }
+    std::list<T>* tris = tree->search( bb, nodes );
+    typename std::list<T>::iterator it,it_end;    // for looping over found triangles
+    it_end = tris->end();
+    int calls = 0;
+    // overlaps() is an exact test, also in z: a triangle entirely above the cutter-length,
+    // which a kd-tree bucket may still return, is not pushed against. pushCutter3() did push
+    // against such triangles, so with short cutters the intervals and loops differ from it.
+    BOOST_FOREACH( unsigned int n, idx ) {
+        Bbox fiber_bb = fiber_bbox( fiberr[n], 0.0, 1.0 );
+        for ( it=tris->begin() ; it!=it_end ; ++it) {
+            if ( tree->overlaps( fiber_bb, *it ) && !covered( fiberr[n], it->bb ) ) {
+                Interval i;
+                cutter->pushCutter(fiberr[n],i,*it);  
+                fiberr[n].addInterval(i); 
+                ++calls;
+            }
+        }
+    }
+    delete( tris );
+    return calls;
+}
+
+// the search-boxes of consecutive segments overlap, and a triangle is found by
+// every segment it overlaps. These segments are consecutive, so the triangle is
+// pushed only by the first one, i.e. when it does not overlap the previous segment.
+// pushCutter() always pushes along the whole fiber, so the intervals are the same
+// as without segments.
+// A segment that lies inside an interval found by earlier segments is not searched:
+// triangles that overlap only this segment can't change the fiber, and triangles
+// reaching outside of it are found by a neighbouring segment.
+template <class T> 
+int BatchPushCutter::push_segments(Fiber& f, KDTree<T>* tree, unsigned long& nodes) {
+    int Nsegments = (int)ceil( (f.p2-f.p1).norm() / segmentLength );
+    int calls = 0;
+    Bbox prev_bb; // the previous segment
+    bool prev_searched = false;
+    for (int k=0; k<Nsegments; ++k) {
+        double t0 = (double)k/Nsegments;
+        double t1 = (double)(k+1)/Nsegments;
+        if ( f.covers( t0, t1 ) ) {
+            prev_searched = false;
+            continue;
+        }
+        Bbox seg_bb = fiber_bbox( f, t0, t1 );
+        std::list<T>* tris = tree->search( seg_bb, nodes );
+        BOOST_FOREACH( const T& t, *tris ) {
+            if ( !tree->overlaps( seg_bb, t ) )
+                continue;
+            if ( prev_searched && tree->overlaps( prev_bb, t ) )
+                continue; // already pushed by the previous segment
+            if ( covered( f, t.bb ) )
+                continue;
+            Interval i;
+            cutter->pushCutter(f,i,t);
+            f.addInterval(i);
+            ++calls;
+        }
+        delete( tris );
+        prev_bb = seg_bb;
+        prev_searched = true;
+    }
+    return calls;
+}
+
+// the work-list holds one item for each packet of each batch. 
+// Each item writes its own calls/nodes slot, and these are summed per batch after the loop.
+void BatchPushCutter::runBatches(const std::vector<BatchPushCutter*>& batches, unsigned int nthreads) {
+    std::vector<BatchPushCutter*> work_batch;
+    std::vector<unsigned int> work_first, work_last;
+    unsigned int Nfibers = 0;
+    BOOST_FOREACH( BatchPushCutter* b, batches ) {
+        if ( !b->slices )
+            b->build_tree(); // before the parallel loop, push_packet() only reads the tree
+        std::vector<unsigned int> packets = b->build_packets();
+        for (unsigned int m=0; m+1<packets.size(); ++m) {
+            work_batch.push_back( b );
+            work_first.push_back( packets[m] );
+            work_last.push_back( packets[m+1] );
+        }
+        Nfibers += b->fibers->size();
+    }
+    int Nwork = work_batch.size();
+    std::vector<int> work_calls( Nwork, 0 );
+    std::vector<unsigned long> work_nodes( Nwork, 0 );
+    boost::progress_display show_progress( Nfibers );
+    int w; // loop variable
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared(work_batch, work_first, work_last, work_calls, work_nodes) private(w)
+    for (w=0; w<Nwork; ++w) {
+        work_calls[w] = work_batch[w]->push_packet( work_first[w], work_last[w], work_nodes[w] );
+        #pragma omp critical
+        show_progress += work_last[w]-work_first[w];
+    } // OpenMP parallel region ends here
+    
+    BOOST_FOREACH( BatchPushCutter* b, batches ) {
+        b->nCalls = 0;
+        b->nNodes = 0;
+    }
+    for (w=0; w<Nwork; ++w) {
+        work_batch[w]->nCalls += work_calls[w];
+        work_batch[w]->nNodes += work_nodes[w];
+    }
+    return;
+}
+
 }// end namespace
 // end file batchpushcutter.cpp
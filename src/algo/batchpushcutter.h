@@ -36,6 +36,7 @@ namespace ocl
 class STLSurf;
 class Triangle;
 class MillingCutter;
+class ZSlice;
 
 ///
 /// BatchPushCutter takes a MillingCutter, an STLSurf, and many Fibers
@@ -47,7 +48,7 @@ class BatchPushCutter : public Operation {
         BatchPushCutter();
         virtual ~BatchPushCutter();
         
-        /// set the STL-surface and build kd-tree
+        /// set the STL-surface. The kd-tree is built on the first run() that searches it
         void setSTL(const STLSurf& s);
 
         /// set this bpc to be x-direction
@@ -56,13 +57,47 @@ class BatchPushCutter : public Operation {
         void setYDirection() {x_direction=false;y_direction=true;}
         /// append to list of Fibers to evaluate
         void appendFiber(Fiber& f);
+        /// remove all Fibers
+        void clearFibers() {fibers->clear();}
+        /// \brief set the length of fiber segments that are searched separately.
+        ///
+        /// with a segment length of zero (the default) the kd-tree is built in the plane
+        /// perpendicular to the fibers, and each search returns all triangles in a slab 
+        /// along the whole fiber. With a positive segment length the kd-tree also has the fiber
+        /// direction as a dimension, fibers longer than the segment length are searched one 
+        /// segment at a time, and shorter fibers close to each other share one search.
+        /// Segments inside an interval that is already known are not searched at all.
+        /// The three-dimensional kd-tree is slower to search, so this pays off only for
+        /// long fibers over large faces, where many segments are skipped.
+        /// must be called before run()
+        void setSegmentLength(double l) {
+            assert( l >= 0.0 );
+            segmentLength = l;
+            treeBuilt = false;
+        }
+        /// return the segment length
+        double getSegmentLength() const {return segmentLength;}
+        /// \brief push against the triangles of precomputed ZSlices.
+        ///
+        /// each fiber is pushed against the ZSlice at its z-height, instead of the kd-tree of the STL-surface,
+        /// which is then never built.
+        /// A Waterline computes one ZSlice per z-height and shares it between its X- and Y-fibers.
+        /// The slices must be sorted by z-height, and every fiber must lie at the z-height of one of them.
+        /// A packet then holds fibers of one z-height only. NULL goes back to the kd-tree.
+        void setSlices(const std::vector<ZSlice*>* s) {slices = s;}
 
         
         /// run push-cutter
-        void run() {this->pushCutter3();}
+        void run() {this->pushCutter4();}
         
         std::vector<Fiber>* getFibers() const {return fibers;}
         
+        /// \brief run several push-cutters as one parallel workload.
+        ///
+        /// the packets of all batches are processed by one OpenMP loop with nthreads threads,
+        /// so e.g. the X- and Y-fibers of a Waterline keep all threads busy without nested parallelism.
+        static void runBatches(const std::vector<BatchPushCutter*>& batches, unsigned int nthreads);
+        
     protected:
         /// 1st version of algorithm
         void pushCutter1();
@@ -70,6 +105,33 @@ class BatchPushCutter : public Operation {
         void pushCutter2();
         /// 3rd version of algorithm
         void pushCutter3();
+        /// 4th version, packets of nearby fibers share one kd-tree search
+        void pushCutter4();
+        /// build the kd-tree of the STL-surface, unless it is already built
+        void build_tree();
+        /// return the CL-point used for the kd-tree search of Fiber f
+        CLPoint search_point(const Fiber& f) const;
+        /// return the bounding-box of the cutter moving along Fiber f from t0 to t1
+        Bbox fiber_bbox(const Fiber& f, double t0, double t1) const;
+        /// return true if Fiber f already has an interval covering all cutter positions 
+        /// that can touch the bounding-box bb. Pushing against anything in bb then can't change f.
+        bool covered(const Fiber& f, const Bbox& bb) const;
+        /// push-cutter for one long fiber, with one search of tree for each segment.
+        /// returns the number of pushCutter() calls, and adds the visited kd-tree nodes to nodes
+        template <class T> int push_segments(Fiber& f, KDTree<T>* tree, unsigned long& nodes);
+        /// push-cutter for the fibers with indices idx, sharing one search of tree.
+        /// returns the number of pushCutter() calls, and adds the visited kd-tree nodes to nodes
+        template <class T> int push_indexed(const std::vector<unsigned int>& idx, KDTree<T>* tree, unsigned long& nodes);
+        /// group consecutive nearby fibers into packets of at most packetSize fibers.
+        /// nearby fibers are within one cutter-diameter in the search-plane, and one cutter-length in z.
+        /// returns the index of the first fiber of each packet, followed by fibers->size()
+        std::vector<unsigned int> build_packets() const;
+        /// true if fibers f1 and f2 may share a packet in z: the same z-height with slices,
+        /// otherwise within one cutter-length.
+        bool same_level(const Fiber& f1, const Fiber& f2) const;
+        /// push-cutter for the packet of fibers [first, last), sharing one kd-tree search.
+        /// returns the number of pushCutter() calls, and adds the visited kd-tree nodes to nodes
+        int push_packet(unsigned int first, unsigned int last, unsigned long& nodes);
         
         /// pointer to list of Fibers
         std::vector<Fiber>* fibers;
@@ -79,6 +141,12 @@ class BatchPushCutter : public Operation {
         bool x_direction;
         /// true if we have y-direction fibers
         bool y_direction;
+        /// length of fiber segments with separate kd-tree searches, zero for no segments
+        double segmentLength;
+        /// the ZSlices to push against, or NULL
+        const std::vector<ZSlice*>* slices;
+        /// true once root is built for the current STL-surface
+        bool treeBuilt;
 };
 
 } // end namespace
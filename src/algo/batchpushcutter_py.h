@@ -21,11 +21,15 @@
 #ifndef BPC_PY_H
 #define BPC_PY_H
 
+#include <sstream>
+#include <string>
+
 #include <boost/python.hpp>
 
 #include "batchpushcutter.h"
 
 #include "fiber_py.h"
+#include "array_py.h"
 
 namespace ocl
 {
@@ -33,11 +37,22 @@ namespace ocl
 class BatchPushCutter_py : public BatchPushCutter {
     public:
         BatchPushCutter_py() : BatchPushCutter() {}
+        /// append fibers from an N-by-2-by-3 array of their start and end points.
+        /// raise ValueError, and append none of them, if a point is not finite, or a fiber
+        /// has zero length or is not parallel to the x- or y-axis
+        void appendFibers(const boost::python::object& a) {
+            ArrayView ends(a, 3, 2, 3);
+            for (unsigned int n=0; n<ends.size(); ++n)
+                check_fiber( ends.point(n,0), ends.point(n,1), n );
+            fibers->reserve( fibers->size() + ends.size() );
+            for (unsigned int n=0; n<ends.size(); ++n)
+                fibers->push_back( Fiber( ends.point(n,0), ends.point(n,1) ) );
+        }
         /// return CL-points to Python
         boost::python::list getCLPoints() const {
             boost::python::list plist;
-            BOOST_FOREACH(Fiber f, *fibers) {
-                BOOST_FOREACH( Interval i, f.ints ) {
+            BOOST_FOREACH(const Fiber& f, *fibers) {
+                BOOST_FOREACH( const Interval& i, f.ints ) {
                     if ( !i.empty() ) {
                         Point tmp = f.point(i.lower);
                         CLPoint p1 = CLPoint( tmp.x, tmp.y, tmp.z );
@@ -73,6 +88,7 @@ class BatchPushCutter_py : public BatchPushCutter {
             } else {
                 assert(0);
             }
+            build_tree();
             overlap_triangles = root->search_cutter_overlap(cutter, &cl);
             
             BOOST_FOREACH(Triangle t, *overlap_triangles) {
@@ -89,7 +105,26 @@ class BatchPushCutter_py : public BatchPushCutter {
             }
             return flist;
         };
-
+        /// return the intervals of the fibers to python as Arrays, see fiber_arrays()
+        boost::python::tuple getFiberArrays() const {
+            return fiber_arrays( *fibers );
+        }
+    protected:
+        /// raise ValueError unless p1 to p2, in row n of an array, is a valid Fiber
+        static void check_fiber(const Point& p1, const Point& p2, unsigned int n) {
+            std::string err;
+            if ( !is_finite(p1) || !is_finite(p2) )
+                err = "is not finite";
+            else if ( p1 == p2 )
+                err = "has zero length";
+            else if ( p1.z != p2.z || ( p1.x != p2.x && p1.y != p2.y ) )
+                err = "is not parallel to the x- or y-axis";
+            if ( !err.empty() ) {
+                std::ostringstream o;
+                o << "fiber " << n << " " << err << ": " << p1 << " " << p2;
+                value_error( o.str() );
+            }
+        }
 };
 
 } // end namespace
@@ -0,0 +1,328 @@
+/*  $Id$
+ * 
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+#include "millingcutter.h"
+#include "clpoint.h"
+#include "stlsurf.h"
+#include "batchdropcutter.h"
+#include "clsurface.h"
+
+namespace ocl
+{
+
+namespace clsurf
+{
+
+// compare vertices by grid key
+struct KeyLess {
+    KeyLess(const std::vector<unsigned long long>& k) : keys(k) {}
+    bool operator()(unsigned int v1, unsigned int v2) const {
+        return keys[v1] < keys[v2];
+    }
+    const std::vector<unsigned long long>& keys;
+};
+
+CutterLocationSurface::CutterLocationSurface() {
+    cutter = NULL;
+    surf = NULL;
+    sampling = 0.1;
+    min_sampling = 0.01;
+    cosLimit = 0.999;
+    nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_num_procs();
+#endif
+    subOp.clear();
+    subOp.push_back( new BatchDropCutter() ); // drops the cutter on the new vertices of each level
+    subOp[0]->setThreads( nthreads );
+}
+
+CutterLocationSurface::~CutterLocationSurface() {
+    delete subOp[0];
+}
+
+std::string CutterLocationSurface::str() const {
+    unsigned int leaves = 0;
+    BOOST_FOREACH( const Cell& c, cells ) {
+        if ( c.child < 0 )
+            leaves++;
+    }
+    std::ostringstream o;
+    o << "CutterLocationSurface (nVerts=" << points.size() << " , nCells=" << cells.size() << " , nLeaves=" << leaves;
+    o << " , nTriangles=" << triangles.size()/3 << ")\n";
+    return o.str();
+}
+
+void CutterLocationSurface::run() {
+    points.clear();
+    keys.clear();
+    sorted.clear();
+    cells.clear();
+    triangles.clear();
+    // the initial cells are subdivided once to the sampling, and then depth-1 times at most
+    double size0 = 2*sampling;
+    depth = 1;
+    while ( (depth < 24) && ( size0/(1<<(depth+1)) >= min_sampling ) )
+        depth++;
+    unit = size0/(1<<depth);
+    double r = cutter->getRadius();
+    minx = surf->bb.minpt.x - r;
+    miny = surf->bb.minpt.y - r;
+    unsigned int Nx = std::max( 1, (int)ceil( (surf->bb.maxpt.x + r - minx)/size0 ) );
+    unsigned int Ny = std::max( 1, (int)ceil( (surf->bb.maxpt.y + r - miny)/size0 ) );
+    std::cout << "CutterLocationSurface::run() " << Nx << "x" << Ny << " cells, " << depth << " levels\n";
+    for (unsigned int j=0; j<=Ny; ++j) {
+        for (unsigned int i=0; i<=Nx; ++i)
+            add_vertex( key(i<<depth, j<<depth) );
+    }
+    drop(0);
+    std::vector<unsigned int> wave;
+    for (unsigned int j=0; j<Ny; ++j) {
+        for (unsigned int i=0; i<Nx; ++i) {
+            Cell c;
+            c.corner[0] = j*(Nx+1) + i;
+            c.corner[1] = j*(Nx+1) + i + 1;
+            c.corner[2] = (j+1)*(Nx+1) + i + 1;
+            c.corner[3] = (j+1)*(Nx+1) + i;
+            c.child = -1;
+            c.level = 0;
+            wave.push_back( cells.size() );
+            cells.push_back(c);
+        }
+    }
+    while ( !wave.empty() ) {
+        subdivide( wave );
+        // the children of the cells that are not flat are subdivided next
+        std::vector<char> refine( wave.size(), 0 );
+        int n;
+        #pragma omp parallel for num_threads(nthreads) schedule(dynamic, 256) private(n)
+        for (n=0; n< (int)wave.size(); ++n)
+            refine[n] = ( cells[ wave[n] ].level+1 < depth ) && !flat( wave[n] );
+        std::vector<unsigned int> next;
+        for (unsigned int m=0; m<wave.size(); ++m) {
+            if ( refine[m] ) {
+                for (int k=0; k<4; ++k)
+                    next.push_back( cells[ wave[m] ].child + k );
+            }
+        }
+        wave.swap( next );
+    }
+    sorted.resize( points.size() );
+    for (unsigned int v=0; v<points.size(); ++v)
+        sorted[v] = v;
+    std::sort( sorted.begin(), sorted.end(), KeyLess(keys) );
+    triangulate();
+    std::cout << str();
+}
+
+void CutterLocationSurface::add_vertex(Key k) {
+    keys.push_back(k);
+    points.push_back( Point( minx + (k >> 32)*unit, miny + (k & 0xffffffffULL)*unit, 0 ) );
+}
+
+void CutterLocationSurface::drop(unsigned int first) {
+    subOp[0]->clearCLPoints();
+    for (unsigned int v=first; v<points.size(); ++v) {
+        CLPoint cl( points[v].x, points[v].y, surf->bb.minpt.z );
+        subOp[0]->appendPoint( cl );
+    }
+    subOp[0]->run();
+    std::vector<CLPoint> clpoints = subOp[0]->getCLPoints();
+    for (unsigned int v=first; v<points.size(); ++v)
+        points[v].z = clpoints[v-first].z;
+    subOp[0]->clearCLPoints();
+}
+
+// the new vertices of one level are all new: they are on the grid of the next level, but not on the grid of this level
+void CutterLocationSurface::subdivide(const std::vector<unsigned int>& wave) {
+    std::vector<Key> newkeys;
+    newkeys.reserve( 5*wave.size() );
+    BOOST_FOREACH( unsigned int c, wave ) {
+        Key k0 = keys[ cells[c].corner[0] ];
+        unsigned int x = k0 >> 32;
+        unsigned int y = k0 & 0xffffffffULL;
+        unsigned int h = 1 << ( depth - cells[c].level - 1 ); // half the size of the cell
+        newkeys.push_back( key(x+h, y) );
+        newkeys.push_back( key(x+2*h, y+h) );
+        newkeys.push_back( key(x+h, y+2*h) );
+        newkeys.push_back( key(x, y+h) );
+        newkeys.push_back( key(x+h, y+h) );
+    }
+    std::sort( newkeys.begin(), newkeys.end() );
+    newkeys.erase( std::unique( newkeys.begin(), newkeys.end() ), newkeys.end() );
+    unsigned int first = points.size();
+    BOOST_FOREACH( Key k, newkeys ) {
+        add_vertex(k);
+    }
+    drop( first );
+    BOOST_FOREACH( unsigned int c, wave ) {
+        Cell parent = cells[c];
+        Key k0 = keys[ parent.corner[0] ];
+        unsigned int x = k0 >> 32;
+        unsigned int y = k0 & 0xffffffffULL;
+        unsigned int h = 1 << ( depth - parent.level - 1 );
+        unsigned int m[5]; // the mid-points of the edges, counterclockwise from the low y edge, and the center
+        Key mk[5] = { key(x+h, y), key(x+2*h, y+h), key(x+h, y+2*h), key(x, y+h), key(x+h, y+h) };
+        for (int i=0; i<5; ++i)
+            m[i] = first + ( std::lower_bound( newkeys.begin(), newkeys.end(), mk[i] ) - newkeys.begin() );
+        unsigned int corners[4][4] = { { parent.corner[0], m[0], m[4], m[3] },
+                                       { m[0], parent.corner[1], m[1], m[4] },
+                                       { m[4], m[1], parent.corner[2], m[2] },
+                                       { m[3], m[4], m[2], parent.corner[3] } };
+        cells[c].child = cells.size();
+        for (int i=0; i<4; ++i) {
+            Cell child;
+            for (int j=0; j<4; ++j)
+                child.corner[j] = corners[i][j];
+            child.child = -1;
+            child.level = parent.level + 1;
+            cells.push_back(child);
+        }
+    }
+}
+
+bool CutterLocationSurface::flat(unsigned int c) const {
+    const Cell& low = cells[ cells[c].child ];      // the low x and low y child
+    const Cell& high = cells[ cells[c].child + 2 ]; // the high x and high y child
+    const Point& p0 = points[ cells[c].corner[0] ];
+    const Point& p1 = points[ cells[c].corner[1] ];
+    const Point& p2 = points[ cells[c].corner[2] ];
+    const Point& p3 = points[ cells[c].corner[3] ];
+    const Point& m0 = points[ low.corner[1] ];
+    const Point& m1 = points[ high.corner[1] ];
+    const Point& m2 = points[ high.corner[3] ];
+    const Point& m3 = points[ low.corner[3] ];
+    const Point& center = points[ low.corner[2] ];
+    return flat(p0, m0, p1) && flat(m3, center, m1) && flat(p3, m2, p2) &&  // the rows
+           flat(p0, m3, p3) && flat(m0, center, m2) && flat(p1, m1, p2);    // the columns
+}
+
+bool CutterLocationSurface::flat(const Point& p1, const Point& p2, const Point& p3) const {
+    Point v1 = p2-p1;
+    Point v2 = p3-p2;
+    v1.normalize();
+    v2.normalize();
+    return (v1.dot(v2) > cosLimit);
+}
+
+int CutterLocationSurface::find_vertex(Key k) const {
+    unsigned int lo = 0, hi = sorted.size();
+    while ( lo < hi ) {
+        unsigned int mid = (lo+hi)/2;
+        if ( keys[ sorted[mid] ] < k )
+            lo = mid+1;
+        else
+            hi = mid;
+    }
+    if ( lo < sorted.size() && keys[ sorted[lo] ] == k )
+        return sorted[lo];
+    return -1;
+}
+
+// a vertex in the middle of an edge is there when the cell on the other side of the edge was subdivided
+void CutterLocationSurface::edge_vertices(unsigned int a, unsigned int b, std::vector<unsigned int>& out) const {
+    Key ka = keys[a];
+    Key kb = keys[b];
+    unsigned int ax = ka >> 32, ay = ka & 0xffffffffULL;
+    unsigned int bx = kb >> 32, by = kb & 0xffffffffULL;
+    if ( ( std::max(ax,bx) - std::min(ax,bx) ) + ( std::max(ay,by) - std::min(ay,by) ) < 2 )
+        return;
+    int mid = find_vertex( key( (ax+bx)/2, (ay+by)/2 ) );
+    if ( mid < 0 )
+        return;
+    edge_vertices( a, mid, out );
+    out.push_back( mid );
+    edge_vertices( mid, b, out );
+}
+
+// each leaf is a convex polygon of its corners and the vertices on its edges. A leaf without
+// vertices on its edges is split into two triangles. Otherwise a vertex is added at its center, and
+// dropped, and the polygon is triangulated as a fan around the center.
+void CutterLocationSurface::triangulate() {
+    std::vector<unsigned int> rings; // the polygons of the leaves, one after the other
+    std::vector<unsigned int> start; // the start of each polygon in rings
+    std::vector<Key> centers;
+    BOOST_FOREACH( const Cell& c, cells ) {
+        if ( c.child >= 0 )
+            continue;
+        start.push_back( rings.size() );
+        for (int i=0; i<4; ++i) {
+            rings.push_back( c.corner[i] );
+            edge_vertices( c.corner[i], c.corner[(i+1)%4], rings );
+        }
+        if ( rings.size() - start.back() > 4 ) {
+            Key k0 = keys[ c.corner[0] ];
+            unsigned int h = 1 << ( depth - c.level - 1 );
+            centers.push_back( key( (k0 >> 32) + h, (k0 & 0xffffffffULL) + h ) );
+        }
+    }
+    start.push_back( rings.size() );
+    unsigned int first = points.size();
+    BOOST_FOREACH( Key k, centers ) {
+        add_vertex(k);
+    }
+    if ( !centers.empty() )
+        drop( first );
+    unsigned int center = first;
+    for (unsigned int n=0; n+1<start.size(); ++n) {
+        const unsigned int* ring = &rings[ start[n] ];
+        unsigned int size = start[n+1] - start[n];
+        if ( size == 4 ) {
+            unsigned int tri[6] = { ring[0], ring[1], ring[2], ring[0], ring[2], ring[3] };
+            triangles.insert( triangles.end(), tri, tri+6 );
+        } else {
+            for (unsigned int i=0; i<size; ++i) {
+                triangles.push_back( center );
+                triangles.push_back( ring[i] );
+                triangles.push_back( ring[ (i+1)%size ] );
+            }
+            center++;
+        }
+    }
+}
+
+std::vector<Point> CutterLocationSurface::getNormals() const {
+    std::vector<Point> normals( points.size(), Point(0,0,0) );
+    for (unsigned int t=0; t<triangles.size(); t+=3) {
+        const Point& p0 = points[ triangles[t] ];
+        Point n = ( points[ triangles[t+1] ] - p0 ).cross( points[ triangles[t+2] ] - p0 );
+        for (int i=0; i<3; ++i)
+            normals[ triangles[t+i] ] += n;
+    }
+    BOOST_FOREACH( Point& n, normals ) {
+        n.normalize();
+    }
+    return normals;
+}
+
+}// end clsurf namespace
+
+} // end ocl namespace
+// end clsurface.cpp
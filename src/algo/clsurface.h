@@ -20,14 +20,11 @@
 #ifndef CLSURFACE_H
 #define CLSURFACE_H
 
+#include <string>
 #include <vector>
-#include <list>
-#include <stack>
-#include <queue>
 
 #include "point.h"
-#include "halfedgediagram.hpp"
-
+#include "operation.h"
 
 namespace ocl
 {
@@ -35,100 +32,24 @@ namespace ocl
 namespace clsurf
 {
 
-struct VertexProps; 
-struct EdgeProps;
-struct FaceProps;
-typedef unsigned int Face;  
-  
-// extra storage in graph:
-typedef HEDIGraph<     boost::listS,             // out-edge storage
-                       boost::listS,             // vertex set storage
-                       boost::bidirectionalS,    // bidirectional graph.
-                       VertexProps,              // vertex properties
-                       EdgeProps,                // edge properties
-                       FaceProps,                // face properties
-                       boost::no_property,       // graph properties
-                       boost::listS             // edge storage
-                       > CLSGraph;
-
-typedef boost::graph_traits< CLSGraph >::vertex_descriptor  Vertex;
-typedef boost::graph_traits< CLSGraph >::vertex_iterator    VertexItr;
-typedef boost::graph_traits< CLSGraph >::edge_descriptor    Edge;
-typedef boost::graph_traits< CLSGraph >::edge_iterator      EdgeItr;
-typedef boost::graph_traits< CLSGraph >::out_edge_iterator  OutEdgeItr;
-typedef boost::graph_traits< CLSGraph >::adjacency_iterator AdjacencyItr;
-
-typedef std::vector<Vertex> VertexVector;
-typedef std::vector<Face> FaceVector;
-typedef std::vector<Edge> EdgeVector;  
-
-
-struct VertexProps {
-    VertexProps() {
-        init();
-    }
-    /// construct vertex at position p with type t
-    VertexProps( Point p) {
-        position=p;
-        init();
-    }
-    void init() {
-        index = count;
-        count++;
-    }
-    //VertexType type;
-// HE data
-    /// the position of the vertex
-    Point position;
-    /// index of vertex
-    int index;
-    /// global vertex count
-    static int count;
-};
-
-int VertexProps::count = 0;
-
-struct EdgeProps {
-    EdgeProps() {}
-    /// create edge with given next, twin, and face
-    EdgeProps(Edge n, Edge t, Face f) { 
-        next = n;
-        twin = t;
-        face = f;
-    }
-    /// the next edge, counterclockwise, from this edge
-    Edge next; 
-    /// the twin edge
-    Edge twin;
-    /// the face to which this edge belongs
-    Face face; 
-};
-/// types of faces in the weave
-//enum 2FaceType {INCIDENT, NONINCIDENT};
-/// properties of a face in the weave
-struct FaceProps {
-    /// create face with given edge, generator, and type
-    FaceProps() {}
-    FaceProps( Edge e ) {
-        edge = e;
-        //type = t;
-    }
-    /// face index
-    Face idx;
-    /// one edge that bounds this face
-    Edge edge;
-    /// face type
-    //W2FaceType type;
-};
-
-
 /// \brief cutter location surface.
 ///
-/// 1) start with a square sized like the bounding-box of the surface
-/// 2) recursively subdivide until we reach sampling
+/// 1) start with a grid of square cells, twice the sampling in size, that covers the surface
+///    and the cutter around it
+/// 2) subdivide each cell once, to the sampling
 /// 3) run drop cutter to project the surface
 /// 4) adaptively subdivide until min_sampling where required
-/// 5) do something:
+///
+/// A cell is subdivided into four, and the five new vertices of every cell subdivided at
+/// one level are dropped together by a BatchDropCutter, in parallel. The children of a cell
+/// are subdivided again when the three rows or the three columns of its nine vertices are
+/// not flat, as in AdaptivePathDropCutter.
+/// Vertices are numbered on the grid of the smallest cells, and the cells are kept in a vector with
+/// the four children of a cell next to each other. The leaf cells are triangulated into a mesh
+/// without cracks: a leaf with vertices of smaller neighbour cells on its edges gets a vertex at its
+/// center, and a fan of triangles around it.
+///
+/// to do with the surface:
 ///    - constant step-over (propagating geodesic windows on square grid is easy?)
 ///    - slicing (?)
 ///    - classify into steep/flat
@@ -143,149 +64,79 @@ struct FaceProps {
 ///
 class CutterLocationSurface : public Operation {
     public:
-        CutterLocationSurface() {
-            far=1.0;
-            init();
-        }
-        /// create diagram with given far-radius and number of bins
-        CutterLocationSurface(double f) {
-            far=f;
-            init();
-        }
-        virtual ~CutterLocationSurface() {  
-        }
-        
-        void init() {
-            // initialize cl-surf
-            //
-            //    b  e1   a
-            //    e2      e4
-            //    c   e3  d
-            Vertex a = hedi::add_vertex( VertexProps( Point(far,far,0) ), g);
-            Vertex b = hedi::add_vertex( VertexProps( Point(-far,far,0) ), g);
-            Vertex c = hedi::add_vertex( VertexProps( Point(-far,-far,0) ), g);
-            Vertex d = hedi::add_vertex( VertexProps( Point(far,-far,0) ), g);
-            Face f_outer= hedi::add_face( FaceProps(), g);
-            Face f_inner= hedi::add_face( FaceProps(), g);
-            Edge e1 = hedi::add_edge(a , b , g);
-            Edge e1t = hedi::add_edge(b , a , g);
-            Edge e2 = hedi::add_edge(b , c , g);
-            Edge e2t = hedi::add_edge(c , b , g);
-            Edge e3 = hedi::add_edge(c , d , g);
-            Edge e3t = hedi::add_edge(d , c , g);
-            Edge e4 = hedi::add_edge(d , a , g);
-            Edge e4t = hedi::add_edge(a , d , g);
-            
-            g[f_inner].edge = e1;
-            g[f_outer].edge = e1t;
-            out_face = f_outer;
-            // twin edges
-            hedi::twin_edges(e1,e1t,g);
-            hedi::twin_edges(e2,e2t,g);
-            hedi::twin_edges(e3,e3t,g);
-            hedi::twin_edges(e4,e4t,g);
-            // inner face:
-            g[e1].face = f_inner;
-            g[e2].face = f_inner;
-            g[e3].face = f_inner;
-            g[e4].face = f_inner;
-            // outer face:
-            g[e1t].face = f_outer;
-            g[e2t].face = f_outer;
-            g[e3t].face = f_outer;
-            g[e4t].face = f_outer;
-            // next-pointers:
-            g[e1].next = e2;
-            g[e2].next = e3;
-            g[e3].next = e4;
-            g[e4].next = e1;
-            // outer next-pointers:
-            g[e1t].next = e4t;
-            g[e4t].next = e3t;
-            g[e3t].next = e2t;
-            g[e2t].next = e1t;
-            
-            subdivide();
-    
-        }
-        
-        void subdivide() {
-            for( Face f=0; f< hedi::num_faces(g) ; ++f ) {
-                // subdivide each face
-                if ( f!= out_face ) {
-                    subdivide_face(f);
-                }
-            }
-        }
-        
-        void subdivide_face(Face f) {
-            EdgeVector f_edges = hedi::face_edges(f,g);
-            assert( f_edges.size() == 4 );
-            Vertex center = hedi::add_vertex( g );
-            BOOST_FOREACH( Edge e, f_edges ) {
-                Vertex src = hedi::source(e,g);
-                Vertex trg = hedi::target(e,g);
-                // new vertex at mid-point of each edge
-                Point mid = 0.5*(g[src].position+g[trg].position);
-                g[center].position += 0.25*g[src].position; // average of four corners
-                Vertex v = hedi::add_vertex( g );
-                g[v].position = mid;
-                hedi::insert_vertex_in_edge(v,e,g); // this also removes the old edges...
-            }
-            // now loop through edges again:
-            f_edges = hedi::face_edges(f,g);
-            assert( f_edges.size() == 8 );
-            BOOST_FOREACH( Edge e, f_edges ) {
-                std::cout << e << "\n";
-            }
-        }
-        
-        virtual void run() {
-        }
-        void setMinSampling(double s) {
-            min_sampling=s;
-        }
-        
-    // PYTHON
-        boost::python::list getVertices() const {
-            boost::python::list plist;
-            BOOST_FOREACH( Vertex v, hedi::vertices(g) ) {
-                plist.append( g[v].position );
-            }
-            return plist;
-        }
-        
-        boost::python::list getEdges() const {
-            boost::python::list edge_list;
-            BOOST_FOREACH( Edge edge, hedi::edges(g) ) { // loop through each edge
-                    boost::python::list point_list; // the endpoints of each edge
-                    Vertex v1 = hedi::source( edge, g );
-                    Vertex v2 = hedi::target( edge, g );
-                    point_list.append( g[v1].position );
-                    point_list.append( g[v2].position );
-                    edge_list.append(point_list);
-            }
-            return edge_list;
-        }
+        CutterLocationSurface();
+        virtual ~CutterLocationSurface();
+        /// set the smallest cell size
+        void setMinSampling(double s) {min_sampling=s;}
+        /// set the cosine limit of the flatness test. 0.999 by default
+        void setCosLimit(double lim) {cosLimit=lim;}
+        /// run the algorithm. setSTL, setCutter, setSampling, and setMinSampling must
+        /// be called before a call to run()
+        virtual void run();
         
+        /// the position of each vertex
+        std::vector<Point> getPoints() const {return points;}
+        /// the triangles of the mesh, three vertex indices each, counterclockwise seen from above
+        std::vector<unsigned int> getTriangles() const {return triangles;}
+        /// the normal of each vertex, the average of the normals of its triangles weighted by area
+        std::vector<Point> getNormals() const;
         /// string repr
-        std::string str() const {
-            std::ostringstream o;
-            o << "CutterLocationSurface (nVerts="<< hedi::num_vertices(g) << " , nEdges="<< hedi::num_edges(g) <<"\n";
-            return o.str();
-        }
+        std::string str() const;
 
     protected:
+        /// a square cell
+        struct Cell {
+            /// the corner vertices, counterclockwise from the low x and low y corner
+            unsigned int corner[4];
+            /// the first of the four child cells, or -1 for a leaf
+            int child;
+            /// the level, 0 for the cells of the initial grid
+            unsigned int level;
+        };
+        /// the grid key of a vertex
+        typedef unsigned long long Key;
+        /// the key of the grid position (ix,iy)
+        static Key key(unsigned int ix, unsigned int iy) {return ( (Key)ix << 32 ) | iy;}
+        /// add a vertex with key k
+        void add_vertex(Key k);
+        /// drop the cutter on the vertices from first to the last one
+        void drop(unsigned int first);
+        /// subdivide the cells, and drop the cutter on the new vertices
+        void subdivide(const std::vector<unsigned int>& cells);
+        /// true if the nine vertices of the subdivided cell c are flat
+        bool flat(unsigned int c) const;
+        /// true if p1, p2, and p3 are on a line, within the cosine limit
+        bool flat(const Point& p1, const Point& p2, const Point& p3) const;
+        /// the index of the vertex with key k, or -1
+        int find_vertex(Key k) const;
+        /// append the vertices strictly between vertices a and b, from a to b
+        void edge_vertices(unsigned int a, unsigned int b, std::vector<unsigned int>& out) const;
+        /// triangulate the leaf cells, and drop the cutter on the new center vertices
+        void triangulate();
         
     // DATA
-        /// the half-edge diagram 
-        CLSGraph g;
+        /// the smallest cell size
         double min_sampling;
-        double far;
-        Face out_face;
+        /// the cosine limit of flat()
+        double cosLimit;
+        /// the lowest corner of the grid
+        double minx, miny;
+        /// the size of the grid unit, the size of the smallest cells
+        double unit;
+        /// the number of levels of subdivision
+        unsigned int depth;
+        /// the positions of the vertices, after drop-cutter
+        std::vector<Point> points;
+        /// the grid key of each vertex
+        std::vector<Key> keys;
+        /// the vertices, sorted by key
+        std::vector<unsigned int> sorted;
+        /// the cells
+        std::vector<Cell> cells;
+        /// the triangles, three vertex indices each
+        std::vector<unsigned int> triangles;
 };
 
-
 }// end clsurf namespace
 
 } // end ocl namespace
@@ -0,0 +1,96 @@
+/*  $Id$
+ * 
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLSURFACE_PY_H
+#define CLSURFACE_PY_H
+
+#include <algorithm>
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "clsurface.h"
+
+namespace ocl
+{
+
+namespace clsurf
+{
+
+/// Python wrapper for CutterLocationSurface
+class CutterLocationSurface_py : public CutterLocationSurface {
+    public:
+        CutterLocationSurface_py() : CutterLocationSurface() {}
+        /// return the vertices as a list of Points to python
+        boost::python::list getVertices() const {
+            boost::python::list plist;
+            BOOST_FOREACH( Point p, points ) {
+                plist.append( p );
+            }
+            return plist;
+        }
+        /// return the vertex normals as a list of Points to python
+        boost::python::list getNormals_py() const {
+            boost::python::list plist;
+            BOOST_FOREACH( Point n, getNormals() ) {
+                plist.append( n );
+            }
+            return plist;
+        }
+        /// return the triangles as a list of lists of three vertex indices to python
+        boost::python::list getTriangles_py() const {
+            boost::python::list tri_list;
+            for (unsigned int t=0; t<triangles.size(); t+=3) {
+                boost::python::list idx;
+                idx.append( triangles[t] );
+                idx.append( triangles[t+1] );
+                idx.append( triangles[t+2] );
+                tri_list.append( idx );
+            }
+            return tri_list;
+        }
+        /// return the edges of the triangles as a list of lists of two Points to python
+        boost::python::list getEdges() const {
+            std::vector< std::pair<unsigned int, unsigned int> > edges;
+            for (unsigned int t=0; t<triangles.size(); t+=3) {
+                for (int i=0; i<3; ++i) {
+                    unsigned int a = triangles[t+i];
+                    unsigned int b = triangles[ t + (i+1)%3 ];
+                    edges.push_back( std::make_pair( std::min(a,b), std::max(a,b) ) );
+                }
+            }
+            std::sort( edges.begin(), edges.end() );
+            edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+            boost::python::list edge_list;
+            for (unsigned int n=0; n<edges.size(); ++n) {
+                boost::python::list point_list; // the endpoints of each edge
+                point_list.append( points[ edges[n].first ] );
+                point_list.append( points[ edges[n].second ] );
+                edge_list.append(point_list);
+            }
+            return edge_list;
+        }
+};
+
+}// end clsurf namespace
+
+} // end ocl namespace
+#endif
+// end clsurface_py.h
@@ -0,0 +1,222 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <iostream>
+
+#include <boost/foreach.hpp>
+
+#include "contourtracer.h"
+
+namespace ocl
+{
+
+namespace weave2
+{
+
+void ContourTracer::addFiber(Fiber& f) {
+    if ( f.dir.xParallel() && !f.empty() ) {
+        fibers[0].push_back(f);
+    } else if ( f.dir.yParallel() && !f.empty() ) {
+        fibers[1].push_back(f);
+    } else if (!f.empty()) {
+        assert(0); // fiber must be either x or y
+    }
+}
+
+double ContourTracer::fiber_coord(int axis, unsigned int fiber) const {
+    const Fiber& f = fibers[axis][fiber];
+    return (axis == 0) ? f.p1.y : f.p1.x;
+}
+
+double ContourTracer::along(int axis, unsigned int fiber, double t) const {
+    Point p = fibers[axis][fiber].point(t);
+    return (axis == 0) ? p.x : p.y;
+}
+
+// the same test as Weave::build_sorted(): the t-value only locates the interval,
+// the interval end-points are compared with c
+int ContourTracer::interval_at(int axis, unsigned int fiber, double c) const {
+    const double t_tol = 1E-9;
+    const Fiber& f = fibers[axis][fiber];
+    double t = (axis == 0) ? ( c - f.p1.x ) / ( f.p2.x - f.p1.x ) : ( c - f.p1.y ) / ( f.p2.y - f.p1.y );
+    std::vector<Interval>::const_iterator it;
+    it = std::lower_bound( f.ints.begin(), f.ints.end(), t-t_tol, upper_below );
+    for ( ; (it != f.ints.end()) && (it->lower <= t+t_tol) ; ++it ) {
+        if ( ( along(axis, fiber, it->lower) <= c ) && ( c <= along(axis, fiber, it->upper) ) )
+            return it - f.ints.begin();
+    }
+    return -1;
+}
+
+// from the lower end we walk up, and the first fiber to test is the first one at or above the lower end.
+// from the upper end we walk down, starting with the last fiber at or below the upper end.
+ContourTracer::Walk ContourTracer::start(const IntervalEnd& e) const {
+    const std::vector< std::pair<double, unsigned int> >& other = sorted[1-e.axis];
+    const Interval& i = fibers[e.axis][e.fiber].ints[e.interval];
+    Walk w;
+    w.axis = e.axis;
+    w.rank = rank[e.axis][e.fiber];
+    w.m = e.interval;
+    if ( e.end == 0 ) {
+        w.dir = 1;
+        double cmin = along(e.axis, e.fiber, i.lower);
+        w.from = std::lower_bound( other.begin(), other.end(), std::make_pair( cmin, 0u ) ) - other.begin() - 1;
+    } else {
+        w.dir = -1;
+        double cmax = along(e.axis, e.fiber, i.upper);
+        w.from = std::upper_bound( other.begin(), other.end(), std::make_pair( cmax, UINT_MAX ) ) - other.begin();
+    }
+    return w;
+}
+
+// the turn follows the next-pointers of Weave: arriving along +x we leave along -y,
+// along +y we leave along +x, along -x we leave along +y, and along -y we leave along -x.
+bool ContourTracer::step(Walk& w, IntervalEnd& e) const {
+    unsigned int fiber = sorted[w.axis][w.rank].second;
+    const Interval& i = fibers[w.axis][fiber].ints[w.m];
+    double cmin = along(w.axis, fiber, i.lower);
+    double cmax = along(w.axis, fiber, i.upper);
+    double c = sorted[w.axis][w.rank].first;
+    const std::vector< std::pair<double, unsigned int> >& other = sorted[1-w.axis];
+    for (int r = w.from + w.dir; (r >= 0) && (r < (int)other.size()) ; r += w.dir) {
+        if ( (other[r].first < cmin) || (cmax < other[r].first) )
+            break; // past the end of the interval
+        int k = interval_at( 1-w.axis, other[r].second, c );
+        if ( k >= 0 ) { // a crossing, turn right
+            w.dir = ( w.axis == 0 ) ? -w.dir : w.dir;
+            w.from = w.rank;
+            w.axis = 1-w.axis;
+            w.rank = r;
+            w.m = k;
+            return true;
+        }
+    }
+    e.axis = w.axis;
+    e.fiber = fiber;
+    e.interval = w.m;
+    e.end = ( w.dir > 0 ) ? 1 : 0;
+    return false;
+}
+
+Point ContourTracer::position(const IntervalEnd& e) const {
+    const Fiber& f = fibers[e.axis][e.fiber];
+    const Interval& i = f.ints[e.interval];
+    return f.point( (e.end == 0) ? i.lower : i.upper );
+}
+
+// a Y-interval is in the graph of Weave only if it crosses an X-interval. It is added
+// with the crossing X-interval that has the lowest fiber index. When the X-fibers were
+// added in y-order, as Waterline does, this is the first crossing from the lower end.
+std::vector<IntervalEnd> ContourTracer::cl_order() const {
+    std::vector< std::pair<CLOrder, IntervalEnd> > order;
+    for (unsigned int nx=0; nx<fibers[0].size(); ++nx) {
+        for (unsigned int mx=0; mx<fibers[0][nx].size(); ++mx) {
+            for (int end=0; end<2; ++end) {
+                CLOrder o = { nx, mx, 0, 0, 0, end };
+                IntervalEnd e = { 0, nx, mx, end };
+                order.push_back( std::make_pair( o, e ) );
+            }
+        }
+    }
+    bool y_ordered = true;
+    for (unsigned int k=0; k<sorted[0].size(); ++k)
+        y_ordered = y_ordered && ( sorted[0][k].second == k );
+    const std::vector< std::pair<double, unsigned int> >& xsorted = sorted[0];
+    for (unsigned int ny=0; ny<fibers[1].size(); ++ny) {
+        const Fiber& yf = fibers[1][ny];
+        for (unsigned int my=0; my<yf.size(); ++my) {
+            double ymin = along(1, ny, yf.ints[my].lower);
+            double ymax = along(1, ny, yf.ints[my].upper);
+            bool found = false;
+            CLOrder first = { 0, 0, 1, rank[1][ny], my, 0 };
+            std::vector< std::pair<double, unsigned int> >::const_iterator it;
+            it = std::lower_bound( xsorted.begin(), xsorted.end(), std::make_pair( ymin, 0u ) );
+            for ( ; (it != xsorted.end()) && (it->first <= ymax) ; ++it ) {
+                int mx = interval_at( 0, it->second, yf.p1.x );
+                if ( mx < 0 )
+                    continue;
+                if ( !found || ( it->second < first.nx ) ) {
+                    first.nx = it->second;
+                    first.mx = mx;
+                    found = true;
+                }
+                if ( y_ordered )
+                    break;
+            }
+            if ( !found )
+                continue;
+            for (int end=0; end<2; ++end) {
+                first.end = end;
+                IntervalEnd e = { 1, ny, my, end };
+                order.push_back( std::make_pair( first, e ) );
+            }
+        }
+    }
+    std::sort( order.begin(), order.end(), first_less< std::pair<CLOrder, IntervalEnd> > );
+    std::vector<IntervalEnd> out;
+    for (unsigned int n=0; n<order.size(); ++n)
+        out.push_back( order[n].second );
+    return out;
+}
+
+// loops are started at CL-points in the order Weave::build() adds them, so the loops
+// are the same, and in the same order, as from Weave::face_traverse()
+void ContourTracer::trace() {
+    for (int axis=0; axis<2; ++axis) {
+        sorted[axis].clear();
+        for (unsigned int n=0; n<fibers[axis].size(); ++n)
+            sorted[axis].push_back( std::make_pair( fiber_coord(axis, n), n ) );
+        std::sort( sorted[axis].begin(), sorted[axis].end() ); // ties are sorted by index
+        rank[axis].resize( fibers[axis].size() );
+        for (unsigned int k=0; k<sorted[axis].size(); ++k)
+            rank[axis][ sorted[axis][k].second ] = k;
+    }
+    std::vector< std::vector<char> > done[2]; // two flags for each interval, one for each end
+    for (int axis=0; axis<2; ++axis) {
+        for (unsigned int n=0; n<fibers[axis].size(); ++n)
+            done[axis].push_back( std::vector<char>( 2*fibers[axis][n].size(), 0 ) );
+    }
+    std::vector<IntervalEnd> starts = cl_order();
+    std::cout << " tracing contours from " << starts.size() << " cl-points\n";
+    BOOST_FOREACH( const IntervalEnd& first, starts ) {
+        if ( done[first.axis][first.fiber][2*first.interval+first.end] ) // already in a loop
+            continue;
+        std::vector<Point> loop; // start on a new loop
+        IntervalEnd current = first;
+        do { // walk around the loop
+            char& visited = done[current.axis][current.fiber][2*current.interval+current.end];
+            assert( !visited ); // each cl-point is in one loop only
+            visited = 1;
+            loop.push_back( position(current) );
+            Walk w = start(current);
+            while ( step(w, current) ) {} // follow the crossings to the next cl-point
+        } while ( (current.axis != first.axis) || (current.fiber != first.fiber) ||
+                  (current.interval != first.interval) || (current.end != first.end) );
+        loops.push_back(loop);
+    }
+}
+
+} // end weave2 namespace
+
+} // end ocl namespace
+// end file contourtracer.cpp
@@ -0,0 +1,100 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTOURTRACER_H
+#define CONTOURTRACER_H
+
+#include <vector>
+
+#include "point.h"
+#include "fiber.h"
+#include "weave2_common.h"
+
+namespace ocl
+{
+
+namespace weave2
+{
+
+/// \brief waterline loops traced directly from the fiber intervals
+///
+/// ContourTracer finds the same loops as Weave::face_traverse(), without building the weave-graph.
+/// The intervals of the X- and Y-fibers are treated as an occupancy field, and each loop is traced
+/// by walking along the intervals, marching-squares style: from a CL-point into its interval, turning
+/// right at every crossing with an interval in the other direction, until the next CL-point is reached.
+/// There the walk turns back along that interval. Only the crossings along the loops are visited,
+/// and apart from the loops the memory used is one flag for each CL-point.
+class ContourTracer {
+    public:
+        ContourTracer() {}
+        virtual ~ContourTracer() {}
+        /// add Fiber f. each fiber should be either in the X or Y-direction
+        void addFiber(Fiber& f);
+        /// trace all loops
+        void trace();
+        /// return the list of loops
+        std::vector< std::vector<Point> > getLoops() const {return loops;}
+
+    protected:
+        /// a position on the walk: moving in direction dir along interval m of fiber number rank in sorted[axis]
+        struct Walk {
+            /// 0 for an X-fiber, 1 for a Y-fiber
+            int axis;
+            /// the position of the fiber in sorted[axis]
+            int rank;
+            /// the interval index
+            unsigned int m;
+            /// +1 for increasing t, -1 for decreasing t
+            int dir;
+            /// the position in sorted[1-axis] of the crossing we are at, or the end of the interval
+            int from;
+        };
+        /// the coordinate of a fiber that is constant, y for an X-fiber, x for a Y-fiber
+        double fiber_coord(int axis, unsigned int fiber) const;
+        /// the coordinate along an X- or Y-fiber of the interval end-point at t
+        double along(int axis, unsigned int fiber, double t) const;
+        /// the index of an interval of a fiber that contains the coordinate c, or -1
+        int interval_at(int axis, unsigned int fiber, double c) const;
+        /// start a walk at the CL-point e, into its interval
+        Walk start(const IntervalEnd& e) const;
+        /// advance w to the next crossing along its interval, and turn right.
+        /// returns false, and sets e, when the walk instead reaches the CL-point e at the end of the interval
+        bool step(Walk& w, IntervalEnd& e) const;
+        /// the CL-points in the order in which Weave::build() adds them
+        std::vector<IntervalEnd> cl_order() const;
+        /// the position of CL-point e
+        Point position(const IntervalEnd& e) const;
+
+    // DATA
+        /// the X-fibers [0] and Y-fibers [1]
+        std::vector<Fiber> fibers[2];
+        /// the fibers sorted by fiber_coord(), as pairs (coordinate, fiber index)
+        std::vector< std::pair<double, unsigned int> > sorted[2];
+        /// the position of each fiber in sorted
+        std::vector<unsigned int> rank[2];
+        /// output: the loops
+        std::vector< std::vector<Point> > loops;
+};
+
+} // end weave2 namespace
+
+} // end ocl namespace
+#endif
+// end file contourtracer.h
@@ -18,6 +18,8 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+
 #include <boost/foreach.hpp>
 
 #include "fiber.h"
@@ -38,7 +40,7 @@ void Fiber::calcDir() {
 }
 
 bool Fiber::contains(Interval& i) const {
-    BOOST_FOREACH( Interval fi, ints) {
+    BOOST_FOREACH( const Interval& fi, ints) {
         if ( i.inside( fi ) )
             return true;
     }
@@ -47,46 +49,55 @@ bool Fiber::contains(Interval& i) const {
 
 bool Fiber::missing(Interval& i) const {
     bool result = true;
-    BOOST_FOREACH( Interval fi, ints) {
+    BOOST_FOREACH( const Interval& fi, ints) {
         if ( !i.outside( fi ) ) // all existing ints must be non-overlapping
             result = false; 
     }
     return result;
 }
 
+// comparisons for the binary searches in addInterval()
+static bool upper_below(const Interval& fi, const double t) {
+    return fi.upper < t;
+}
+
+static bool lower_above(const double t, const Interval& fi) {
+    return t < fi.lower;
+}
+
+// binary search for the only interval that can contain [lower, upper]
+bool Fiber::covers(double lower, double upper) const {
+    std::vector<Interval>::const_iterator itr = std::lower_bound( ints.begin(), ints.end(), lower, upper_below );
+    if ( itr == ints.end() )
+        return false;
+    return ( (lower > itr->lower) && (upper < itr->upper) );
+}
+
+// the intervals in ints are kept sorted and non-overlapping, so both 
+// lower and upper increase along ints.
+// the intervals overlapping i form the range [first, last) which is found
+// with two binary searches. The range is merged with i into *first.
 void Fiber::addInterval(Interval& i) {
     if (i.empty())
         return; // do nothing.
-    
-    if (ints.empty()) { // empty fiber case
-        ints.push_back(i); 
+    // first interval that is not completely below i
+    std::vector<Interval>::iterator first = std::lower_bound( ints.begin(), ints.end(), i.lower, upper_below );
+    // first interval that is completely above i
+    std::vector<Interval>::iterator last = std::upper_bound( first, ints.end(), i.upper, lower_above );
+    if ( first == last ) { // no overlaps, insert i at its place
+        ints.insert(first, i); 
         return;
-    } else if ( this->contains(i)  ) { // if fiber already contains i  
+    } else if ( (last-first == 1) && i.inside( *first ) ) { // if fiber already contains i  
         return; // do nothing
-    } else if ( this->missing(i) ) { // if fiber doesn't contain i 
-        ints.push_back(i);
-        return;
     } else {
-        // this is the messier general case with partial overlap
-        std::vector<Interval>::iterator itr;
-        itr = ints.begin();
-        std::vector<Interval> overlaps;
-        while (itr!=ints.end()) { // loop through all intervals
-            if ( ! (itr->outside( i )) ) {
-                overlaps.push_back(*itr); // add overlaps here
-                itr = ints.erase(itr); // erase overlaps from ints
-            } else {
-                ++itr;
-            }
-        }
-        overlaps.push_back(i);
-        // now build a new interval from i and the overlaps
-        Interval sumint;        
-        BOOST_FOREACH(Interval intr, overlaps) {
-            sumint.updateLower( intr.lower, intr.lower_cc );
-            sumint.updateUpper( intr.upper, intr.upper_cc );
+        // the general case with partial overlap
+        // grow *first to cover the overlapping intervals and i
+        for (std::vector<Interval>::iterator itr=first+1; itr!=last; ++itr) {
+            first->updateUpper( itr->upper, itr->upper_cc );
         }
-        ints.push_back(sumint); // add the sum-interval to ints
+        first->updateLower( i.lower, i.lower_cc );
+        first->updateUpper( i.upper, i.upper_cc );
+        ints.erase(first+1, last);
         return;
     }
 }
@@ -104,7 +115,7 @@ Point Fiber::point(double t) const {
 
 void Fiber::printInts() const {
     int n=0;
-    BOOST_FOREACH( Interval i, ints) {
+    BOOST_FOREACH( const Interval& i, ints) {
         std::cout << n << ": [ " << i.lower << " , " << i.upper << " ]" << "\n";
         ++n;
     }
@@ -44,6 +44,8 @@ class Fiber {
         bool contains(Interval& i) const;
         /// return true if Interval i is completely missing (no overlaps) from Fiber
         bool missing(Interval& i) const;
+        /// return true if [lower, upper] is strictly inside one interval of this Fiber
+        bool covers(double lower, double upper) const;
        
         //void condense();  // REMOVE??
         /// t-value corresponding to Point p
@@ -76,7 +78,7 @@ class Fiber {
         Point p2;
         /// direction vector (normalized)
         Point dir;
-        /// the intervals in this Fiber
+        /// the intervals in this Fiber, sorted and non-overlapping
         std::vector<Interval> ints;
     protected:
         /// set the direction(tangent) vector
@@ -39,7 +39,7 @@ class Fiber_py : public Fiber {
         /// return a list of intervals to python
         boost::python::list getInts() const {
             boost::python::list l;
-            BOOST_FOREACH( Interval i, ints) {
+            BOOST_FOREACH( const Interval& i, ints) {
                 l.append( i );
             }
             return l;
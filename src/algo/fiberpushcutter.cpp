@@ -80,7 +80,6 @@ void FiberPushCutter::pushCutter1(Fiber& f) {
 
 void FiberPushCutter::pushCutter2(Fiber& f) {
     std::list<Triangle>::iterator it,it_end;    // for looping over found triangles
-    Interval* i;
     std::list<Triangle>* tris;
     CLPoint cl;
     if ( x_direction ) {
@@ -94,14 +93,17 @@ void FiberPushCutter::pushCutter2(Fiber& f) {
     }
     tris = root->search_cutter_overlap(cutter, &cl);
     it_end = tris->end();
+    int calls = 0;
     for ( it=tris->begin() ; it!=it_end ; ++it) {
-		i = new Interval();
-		cutter->pushCutter(f,*i,*it);
-		f.addInterval(*i); 
-		++nCalls;
-		delete i;
+		Interval i;
+		cutter->pushCutter(f,i,*it);
+		f.addInterval(i); 
+		++calls;
     }
     delete( tris );
+    // AdaptiveWaterline calls this from many OpenMP tasks at once
+    #pragma omp atomic
+    nCalls += calls;
 }
 
 }// end namespace
@@ -20,22 +20,24 @@
 #ifndef INTERVAL_H
 #define INTERVAL_H
 
+#include <cassert>
+#include <sstream>
 #include <vector>
 
 #include "ccpoint.h"
-#include "weave2_typedef.h"
 
 namespace ocl
 {
 
-/// interval for use by fiber and weave
+/// interval for use by fiber and push-cutter
 /// a parameter interval [upper, lower]
+/// this is a small value-type, created on the stack for each triangle in push-cutter.
+/// the bookkeeping needed by the weave is kept by weave2::Weave, not here.
 class Interval {
     public:
         Interval();
         /// create and interval [l,u]  (is this ever called??)
         Interval(const double l, const double u);
-        virtual ~Interval() {};
         
         /// update upper with t, and corresponding cc-point p
         void updateUpper(const double t, CCPoint& p);
@@ -63,12 +65,6 @@ class Interval {
         double upper; 
         /// the lower t-value
         double lower;
-        
-        /// flag for use by Weave::build()
-        bool in_weave; 
-        /// intersections with other intervals are stored in this set of
-        /// VertexPairs of type std::pair<VertexDescriptor, double>
-        weave2::VertexIntersectionSet intersections2;
 };
 
 } // end namespace
@@ -0,0 +1,247 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#include "loopsequencer.h"
+
+namespace ocl
+{
+
+// compare loops by the low x-coordinate of their bounding box
+struct MinXLess {
+    MinXLess(const std::vector<Bbox>& b) : bbox(b) {}
+    bool operator()(unsigned int l1, unsigned int l2) const {
+        return bbox[l1].minpt.x < bbox[l2].minpt.x;
+    }
+    const std::vector<Bbox>& bbox;
+};
+
+LoopSequencer::LoopSequencer() {
+    islandOrder = false;
+    travel = 0.0;
+    first.push_back(0);
+    levelStart.push_back(0);
+}
+
+void LoopSequencer::addLevel(const std::vector< std::vector<Point> >& loops) {
+    BOOST_FOREACH( const std::vector<Point>& loop, loops ) {
+        Bbox b;
+        BOOST_FOREACH( const Point& p, loop ) {
+            points.push_back(p);
+            boost::simple_point<double> q;
+            q.x = p.x;
+            q.y = p.y;
+            xy.push_back(q);
+            owner.push_back( bbox.size() );
+            b.addPoint(p);
+        }
+        bbox.push_back(b);
+        first.push_back( points.size() );
+    }
+    levelStart.push_back( bbox.size() );
+}
+
+void LoopSequencer::addWaterline(const Waterline& w) {
+    addLevel( w.getLoops() );
+}
+
+void LoopSequencer::addLevels(const MultiLevelWaterline& w) {
+    for (unsigned int n=0; n<w.getLevels(); ++n)
+        addLevel( w.getLoops(n) );
+}
+
+void LoopSequencer::clear() {
+    points.clear();
+    xy.clear();
+    first.assign(1, 0);
+    owner.clear();
+    levelStart.assign(1, 0);
+    bbox.clear();
+    sequence.clear();
+    travel = 0.0;
+}
+
+void LoopSequencer::run() {
+    sequence.clear();
+    travel = 0.0;
+    current = start;
+    if ( islandOrder )
+        run_islands();
+    else
+        run_levels();
+}
+
+std::vector< std::vector<Point> > LoopSequencer::getLoops() const {
+    std::vector< std::vector<Point> > loops;
+    BOOST_FOREACH( const LoopEntry& e, sequence ) {
+        unsigned int l = levelStart[e.level] + e.loop;
+        unsigned int v = first[l] + e.entry;
+        std::vector<Point> loop( points.begin()+v, points.begin()+first[l+1] );
+        loop.insert( loop.end(), points.begin()+first[l], points.begin()+v );
+        loops.push_back(loop);
+    }
+    return loops;
+}
+
+void LoopSequencer::visit(unsigned int l, unsigned int v) {
+    LoopEntry e;
+    e.level = std::upper_bound( levelStart.begin(), levelStart.end(), l ) - levelStart.begin() - 1;
+    e.loop = l - levelStart[e.level];
+    e.entry = v - first[l];
+    sequence.push_back(e);
+    travel += ( points[v] - current ).norm();
+    current = points[v];
+}
+
+void LoopSequencer::run_levels() {
+    for (unsigned int k=0; k+1<levelStart.size(); ++k) {
+        std::vector<unsigned int> idx;
+        for (unsigned int v=first[ levelStart[k] ]; v<first[ levelStart[k+1] ]; ++v)
+            idx.push_back(v);
+        if ( idx.empty() )
+            continue;
+        PointTree tree;
+        tree.build( xy, idx );
+        unsigned int left = idx.size();
+        while ( left > 0 ) { // the nearest loop, entered at its nearest point
+            boost::simple_point<double> c;
+            c.x = current.x;
+            c.y = current.y;
+            unsigned int v = tree.nearest_live(c);
+            unsigned int l = owner[v];
+            visit( l, v );
+            remove_points( tree, l );
+            left -= first[l+1] - first[l];
+        }
+    }
+}
+
+void LoopSequencer::run_islands() {
+    std::vector< std::vector<unsigned int> > below;
+    std::vector<unsigned int> nabove = find_below( below );
+    // the loops with no loop above them are found with the tree, the others when they are ready
+    std::vector<unsigned int> idx;
+    for (unsigned int l=0; l<bbox.size(); ++l) {
+        if ( nabove[l] == 0 ) {
+            for (unsigned int v=first[l]; v<first[l+1]; ++v)
+                idx.push_back(v);
+        }
+    }
+    PointTree tree;
+    tree.build( xy, idx );
+    unsigned int left = idx.size();
+    std::vector<unsigned int> stack; // the ready loops, nearest to the loop above them last
+    std::vector< std::pair<double, unsigned int> > ready;
+    for (;;) {
+        unsigned int l, v;
+        if ( !stack.empty() ) {
+            l = stack.back();
+            stack.pop_back();
+            v = nearest_point(l);
+        } else if ( left > 0 ) {
+            boost::simple_point<double> c;
+            c.x = current.x;
+            c.y = current.y;
+            v = tree.nearest_live(c);
+            l = owner[v];
+            remove_points( tree, l );
+            left -= first[l+1] - first[l];
+        } else {
+            break;
+        }
+        visit( l, v );
+        ready.clear();
+        BOOST_FOREACH( unsigned int b, below[l] ) {
+            if ( --nabove[b] == 0 )
+                ready.push_back( std::make_pair( -( points[ nearest_point(b) ] - current ).norm(), b ) );
+        }
+        std::sort( ready.begin(), ready.end() );
+        for (unsigned int m=0; m<ready.size(); ++m)
+            stack.push_back( ready[m].second );
+    }
+}
+
+// the bounding boxes of two consecutive levels are swept in x-order. a box is compared
+// with the boxes of the other level that it overlaps in x, and those it also overlaps in y are a pair.
+std::vector<unsigned int> LoopSequencer::find_below(std::vector< std::vector<unsigned int> >& below) const {
+    below.assign( bbox.size(), std::vector<unsigned int>() );
+    std::vector<unsigned int> nabove( bbox.size(), 0 );
+    for (unsigned int k=0; k+2<levelStart.size(); ++k) {
+        std::vector<unsigned int> sorted[2]; // the loops of level k and k+1, in x-order
+        for (int s=0; s<2; ++s) {
+            for (unsigned int l=levelStart[k+s]; l<levelStart[k+s+1]; ++l) {
+                if ( first[l+1] > first[l] ) // empty loops are left out
+                    sorted[s].push_back(l);
+            }
+            std::sort( sorted[s].begin(), sorted[s].end(), MinXLess(bbox) );
+        }
+        std::vector<unsigned int> active[2];
+        unsigned int next[2] = {0, 0};
+        while ( next[0] < sorted[0].size() || next[1] < sorted[1].size() ) {
+            int s = ( next[1] == sorted[1].size() ||
+                      ( next[0] < sorted[0].size() &&
+                        bbox[ sorted[0][next[0]] ].minpt.x <= bbox[ sorted[1][next[1]] ].minpt.x ) ) ? 0 : 1;
+            unsigned int a = sorted[s][ next[s]++ ];
+            std::vector<unsigned int>& other = active[1-s];
+            for (unsigned int m=0; m<other.size(); ) {
+                unsigned int b = other[m];
+                if ( bbox[b].maxpt.x < bbox[a].minpt.x ) { // b is left of all later boxes
+                    other[m] = other.back();
+                    other.pop_back();
+                    continue;
+                }
+                if ( bbox[b].minpt.y <= bbox[a].maxpt.y && bbox[a].minpt.y <= bbox[b].maxpt.y ) {
+                    unsigned int upper = ( s == 0 ) ? a : b;
+                    unsigned int lower = ( s == 0 ) ? b : a;
+                    below[upper].push_back(lower);
+                    nabove[lower]++;
+                }
+                ++m;
+            }
+            active[s].push_back(a);
+        }
+    }
+    return nabove;
+}
+
+unsigned int LoopSequencer::nearest_point(unsigned int l) const {
+    unsigned int best = first[l];
+    double best_d = ( points[best] - current ).xyNorm();
+    for (unsigned int v=first[l]+1; v<first[l+1]; ++v) {
+        double d = ( points[v] - current ).xyNorm();
+        if ( d < best_d ) {
+            best_d = d;
+            best = v;
+        }
+    }
+    return best;
+}
+
+void LoopSequencer::remove_points(PointTree& tree, unsigned int l) const {
+    for (unsigned int v=first[l]; v<first[l+1]; ++v)
+        tree.remove(v);
+}
+
+} // end namespace
+// end file loopsequencer.cpp
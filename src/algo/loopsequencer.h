@@ -0,0 +1,125 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOP_SEQUENCER_H
+#define LOOP_SEQUENCER_H
+
+#include <vector>
+
+#include "point.h"
+#include "bbox.h"
+#include "pointtree.h"
+#include "waterline.h"
+#include "multilevelwaterline.h"
+
+namespace ocl
+{
+
+/// a loop in the order of a LoopSequencer
+struct LoopEntry {
+    /// the level of the loop, in the order the levels were added
+    unsigned int level;
+    /// the loop, in the order of its level
+    unsigned int loop;
+    /// the point of the loop where the cutter enters and leaves it
+    unsigned int entry;
+};
+
+/// \brief LoopSequencer orders closed loops, such as waterline loops, to keep the rapid moves short
+///
+/// The cutter moves from the start point to the entry point of the first loop, goes around the loop
+/// back to the entry point, and moves on to the entry point of the next loop.
+/// The levels are cut in the order they were added, usually from the top down.
+/// By default all loops of a level are cut before the next level. The loops are chosen nearest first,
+/// and each is entered at its point nearest to the cutter, found with a PointTree of the loop-points.
+///
+/// In island order a loop is below a loop of the previous level when their bounding boxes overlap
+/// in the xy-plane. A loop is cut when all loops above it are cut, and after a loop the cutter goes
+/// down to the nearest loop below it, depth-first. When no loop below is ready the cutter goes to
+/// the nearest loop that has no loop above it.
+/// Both orders take O(n log n) time for n loop-points.
+class LoopSequencer {
+    public:
+        LoopSequencer();
+        virtual ~LoopSequencer() {}
+        /// add the loops of the next level
+        void addLevel(const std::vector< std::vector<Point> >& loops);
+        /// add the loops of a Waterline as the next level
+        void addWaterline(const Waterline& w);
+        /// add the loops of each level of a MultiLevelWaterline
+        void addLevels(const MultiLevelWaterline& w);
+        /// set the position of the cutter before the first loop. the default is the origin
+        void setStart(const Point& p) {start = p;}
+        /// cut the levels one at a time (false, the default), or in depth-first island order (true)
+        void setIslandOrder(bool b) {islandOrder = b;}
+        /// order the loops
+        void run();
+        /// the loops in cutting order
+        std::vector<LoopEntry> getSequence() const {return sequence;}
+        /// the loops in cutting order, each starting at its entry point
+        std::vector< std::vector<Point> > getLoops() const;
+        /// the total length of the rapid moves, from the start point to the last entry point
+        double getTravel() const {return travel;}
+        /// remove all levels
+        void clear();
+
+    protected:
+        /// cut loop l, entering it at point v
+        void visit(unsigned int l, unsigned int v);
+        /// order the loops of each level
+        void run_levels();
+        /// order the loops in island order
+        void run_islands();
+        /// the loops of level k+1 below each loop of level k. returns the number of loops above each loop
+        std::vector<unsigned int> find_below(std::vector< std::vector<unsigned int> >& below) const;
+        /// the point of loop l nearest to the cutter in the xy-plane
+        unsigned int nearest_point(unsigned int l) const;
+        /// remove the points of loop l from tree
+        void remove_points(PointTree& tree, unsigned int l) const;
+
+    // DATA
+        /// the loop-points of all loops. the points of loop l are first[l] to first[l+1]-1
+        std::vector<Point> points;
+        /// the loop-points in the xy-plane, for the PointTree
+        std::vector< boost::simple_point<double> > xy;
+        /// the first point of each loop, and one past the last point of the last loop
+        std::vector<unsigned int> first;
+        /// the loop of each point
+        std::vector<unsigned int> owner;
+        /// the first loop of each level, and one past the last loop of the last level
+        std::vector<unsigned int> levelStart;
+        /// the bounding box of each loop
+        std::vector<Bbox> bbox;
+        /// the start point
+        Point start;
+        /// depth-first island order
+        bool islandOrder;
+        /// the position of the cutter
+        Point current;
+        /// the result
+        std::vector<LoopEntry> sequence;
+        /// the length of the rapid moves
+        double travel;
+};
+
+} // end namespace
+#endif
+// end file loopsequencer.h
@@ -0,0 +1,71 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOP_SEQUENCER_PY_H
+#define LOOP_SEQUENCER_PY_H
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "loopsequencer.h"
+
+namespace ocl
+{
+
+/// Python wrapper for LoopSequencer
+class LoopSequencer_py : public LoopSequencer {
+    public:
+        LoopSequencer_py() : LoopSequencer() {}
+        /// add a list of loops, each a list of Points, as the next level
+        void addLevel_py(const boost::python::list& loop_list) {
+            std::vector< std::vector<Point> > loops( boost::python::len(loop_list) );
+            for (unsigned int n=0; n<loops.size(); ++n) {
+                boost::python::list point_list = boost::python::extract<boost::python::list>( loop_list[n] );
+                for (int m=0; m<boost::python::len(point_list); ++m)
+                    loops[n].push_back( boost::python::extract<Point>( point_list[m] ) );
+            }
+            addLevel( loops );
+        }
+        /// return the sequence as a list of LoopEntry to python
+        boost::python::list getSequence_py() const {
+            boost::python::list entry_list;
+            BOOST_FOREACH( LoopEntry e, sequence ) {
+                entry_list.append( e );
+            }
+            return entry_list;
+        }
+        /// return the loops in cutting order as a list of lists to python
+        boost::python::list getLoops_py() const {
+            boost::python::list loop_list;
+            BOOST_FOREACH( const std::vector<Point>& loop, getLoops() ) {
+                boost::python::list point_list;
+                BOOST_FOREACH( Point p, loop ) {
+                    point_list.append( p );
+                }
+                loop_list.append(point_list);
+            }
+            return loop_list;
+        }
+};
+
+} // end namespace
+#endif
+// end file loopsequencer_py.h
@@ -0,0 +1,95 @@
+/*  $Id$
+ * 
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/foreach.hpp> 
+
+#include "millingcutter.h"
+#include "point.h"
+#include "multilevelwaterline.h"
+
+namespace ocl
+{
+
+//********   ********************** */
+
+MultiLevelWaterline::MultiLevelWaterline() : Waterline() {
+}
+
+MultiLevelWaterline::~MultiLevelWaterline() {
+    std::cout << "~MultiLevelWaterline()\n";
+}
+
+void MultiLevelWaterline::run() {
+    std::cout << "MultiLevelWaterline::run() " << levels.size() << " levels\n";
+    level_loops.clear();
+    if ( levels.empty() )
+        return;
+    this->init_level_fibers();
+    this->push_fibers( levels );
+    
+    // the fibers are ordered by level, then by xy-position
+    const unsigned int Nlevels = levels.size();
+    const std::vector<Fiber>& all_xfibers = *( subOp[0]->getFibers() );
+    const std::vector<Fiber>& all_yfibers = *( subOp[1]->getFibers() );
+    const unsigned int Nx = all_xfibers.size() / Nlevels;
+    const unsigned int Ny = all_yfibers.size() / Nlevels;
+    level_loops.assign( Nlevels, std::vector< std::vector<Point> >() );
+    // the levels are independent, so each one is woven on its own thread,
+    // and a TiledWeave builds its strips on that thread only
+    int k;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) private(k)
+    for (k=0; k<(int)Nlevels; ++k) { // PARALLEL OpenMP loop over levels
+        std::vector<Fiber> xf( all_xfibers.begin() + k*Nx, all_xfibers.begin() + (k+1)*Nx );
+        std::vector<Fiber> yf( all_yfibers.begin() + k*Ny, all_yfibers.begin() + (k+1)*Ny );
+        weave2_process( xf, yf, level_loops[k], 1 );
+    } // end OpenMP PARALLEL for
+}
+
+// the same fiber grid as Waterline::init_fibers(), with one fiber for each level
+// at each xy-position. The fibers of one level are consecutive, so that
+// BatchPushCutter packets hold nearby fibers that share one ZSlice.
+void MultiLevelWaterline::init_level_fibers() {
+    std::cout << " MultiLevelWaterline::init_level_fibers()\n";
+    subOp[0]->clearFibers();
+    subOp[1]->clearFibers();
+    double minx = surf->bb.minpt.x - 2*cutter->getRadius();
+    double maxx = surf->bb.maxpt.x + 2*cutter->getRadius();
+    double miny = surf->bb.minpt.y - 2*cutter->getRadius();
+    double maxy = surf->bb.maxpt.y + 2*cutter->getRadius();
+    int Nx = (int)( (maxx-minx)/sampling );
+    int Ny = (int)( (maxy-miny)/sampling );
+    std::vector<double> xvals = generate_range(minx,maxx,Nx);
+    std::vector<double> yvals = generate_range(miny,maxy,Ny);
+    BOOST_FOREACH( double z, levels ) {
+        BOOST_FOREACH( double y, yvals ) {
+            Fiber f = Fiber( Point( minx, y, z ) , Point( maxx, y, z ) );
+            subOp[0]->appendFiber( f );
+        }
+    }
+    BOOST_FOREACH( double z, levels ) {
+        BOOST_FOREACH( double x, xvals ) {
+            Fiber f = Fiber( Point( x, miny, z ) , Point( x, maxy, z ) );
+            subOp[1]->appendFiber( f );
+        }
+    }
+}
+
+}// end namespace
+// end file multilevelwaterline.cpp
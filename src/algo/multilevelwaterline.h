@@ -0,0 +1,84 @@
+/*  $Id$
+ * 
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MULTILEVELWATERLINE_H
+#define MULTILEVELWATERLINE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "point.h"
+#include "fiber.h"
+#include "waterline.h"
+
+namespace ocl
+{
+
+/// \brief waterline toolpaths at many z-heights
+///
+/// MultiLevelWaterline computes Waterline loops at all z-heights added with addLevel()
+/// in one run(). A ZSlice is computed for each level, in parallel over the levels, and the X- and 
+/// Y-fibers of all levels are pushed in one parallel run. The fibers of one level are consecutive, 
+/// so each packet of nearby fibers shares one search of the ZSlice of its level. 
+/// There is no index shared by all levels: a ZSlice holds the SlicedTriangles of its own z-height,
+/// and fibers at the same xy-position on different levels search their own ZSlice.
+/// The loops of the levels are then woven in parallel, one level per thread.
+class MultiLevelWaterline : public Waterline {
+    public:
+        /// create an empty MultiLevelWaterline object
+        MultiLevelWaterline(); 
+        virtual ~MultiLevelWaterline();
+        
+        /// add a z-height at which to compute waterline loops
+        void addLevel(const double z) {
+            levels.push_back(z);
+        }
+        /// remove all z-heights
+        void clearLevels() {
+            levels.clear();
+            level_loops.clear();
+        }
+        /// return the number of levels
+        unsigned int getLevels() const {return levels.size();}
+        /// run the MultiLevelWaterline algorithm. setSTL, setCutter, setSampling, and addLevel must
+        /// be called before a call to run()
+        virtual void run();
+        
+        /// returns the loops of level n, in the order the levels were added.
+        /// throws std::out_of_range if there is no level n, or run() has not been called
+        std::vector< std::vector<Point> >  getLoops(unsigned int n) const {
+            return level_loops.at(n);
+        }
+        
+    protected:
+        /// initialization of fibers for all levels
+        void init_level_fibers();
+        
+    // DATA
+        /// the z-heights
+        std::vector<double> levels;
+        /// the results, a list of loops for each level
+        std::vector< std::vector< std::vector<Point> > > level_loops;
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,73 @@
+/*  $Id$
+ * 
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MULTILEVELWATERLINE_PY_H
+#define MULTILEVELWATERLINE_PY_H
+
+#include <sstream>
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "multilevelwaterline.h"
+#include "array_py.h"
+
+namespace ocl
+{
+
+/// Python wrapper for MultiLevelWaterline
+class MultiLevelWaterline_py : public MultiLevelWaterline {
+    public:
+        MultiLevelWaterline_py() : MultiLevelWaterline() {}
+        /// return the loops of level n as a list of lists to python.
+        /// raise IndexError if there is no level n, or run() has not been called
+        boost::python::list py_getLoops(unsigned int n) const {
+            check_level(n);
+            boost::python::list loop_list;
+            BOOST_FOREACH( const std::vector<Point>& loop, level_loops[n] ) {
+                boost::python::list point_list;
+                BOOST_FOREACH( Point p, loop ) {
+                    point_list.append( p );
+                }
+                loop_list.append(point_list);
+            }
+            return loop_list;
+        }
+        /// return the loops of level n to python as Arrays, see loop_arrays().
+        /// raise IndexError if there is no level n, or run() has not been called
+        boost::python::tuple getLoopArrays(unsigned int n) const {
+            check_level(n);
+            return loop_arrays( level_loops[n] );
+        }
+    protected:
+        /// raise a python IndexError if run() has computed no loops for level n
+        void check_level(unsigned int n) const {
+            if ( n >= level_loops.size() ) {
+                std::ostringstream o;
+                o << "no loops for level " << n << ", run() has computed " << level_loops.size() << " levels";
+                PyErr_SetString( PyExc_IndexError, o.str().c_str() );
+                boost::python::throw_error_already_set();
+            }
+        }
+};
+
+} // end namespace
+
+#endif
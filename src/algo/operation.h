@@ -41,7 +41,10 @@ class MillingCutter;
 /// base-class for cam algorithms
 class Operation {
     public:
-        Operation() {}
+        Operation() {
+            nNodes = 0;
+            packetSize = 1;
+        }
         virtual ~Operation() {
             std::cout << "~Operation()\n";
         }
@@ -79,6 +82,18 @@ class Operation {
         }
         /// return number of low-level calls
         int getCalls() const {return nCalls;}
+        /// return number of kd-tree nodes visited during the last run()
+        unsigned long getNodes() const {return nNodes;}
+        /// set the maximum number of nearby CL-points or Fibers that share one kd-tree search.
+        /// a packet-size of 1 searches the kd-tree separately for each CL-point or Fiber.
+        void setPacketSize(unsigned int s) {
+            packetSize = s;
+            BOOST_FOREACH(Operation* op, subOp) {
+                op->setPacketSize(packetSize);
+            }
+        }
+        /// return the packet-size
+        unsigned int getPacketSize() const {return packetSize;}
         
         /// set the sampling interval for this Operation and all sub-operations
         virtual void setSampling(double s) {
@@ -110,8 +125,12 @@ class Operation {
         virtual void setXDirection() {}
         /// used by batchpushcutter
         virtual void setYDirection() {}
+        /// used by batchpushcutter
+        virtual void setSegmentLength(double l) {}
         /// add a fiber input to a push-cutter type operation
         virtual void appendFiber( Fiber& f ) {}
+        /// remove all fibers from a push-cutter type operation
+        virtual void clearFibers() {}
         /// return the result of a push-cutter type operation
         virtual std::vector<Fiber>* getFibers() const {return 0;}
         
@@ -120,6 +139,10 @@ class Operation {
         double sampling;
         /// how many low-level calls were made
         int nCalls;
+        /// how many kd-tree nodes were visited
+        unsigned long nNodes;
+        /// maximum number of CL-points or Fibers in a packet-search
+        unsigned int packetSize;
         /// size of bucket-node in KD-tree
         unsigned int bucketSize;
         /// the MillingCutter used
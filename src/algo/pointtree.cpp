@@ -0,0 +1,181 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <limits>
+#include <algorithm>
+
+#include "pointtree.h"
+
+namespace ocl {
+
+// the largest leaf of a PointTree
+static const unsigned int LEAF_SIZE = 8;
+
+typedef boost::simple_point<double> Pnt;
+
+static double dist_sq(const Pnt& p1, const Pnt& p2) {
+    return (p1.x-p2.x)*(p1.x-p2.x) + (p1.y-p2.y)*(p1.y-p2.y);
+}
+
+// compare points by x or y
+struct AxisLess {
+    AxisLess(const std::vector<Pnt>& p, bool y) : points(p), yaxis(y) {}
+    bool operator()(unsigned int i, unsigned int j) const {
+        return yaxis ? points[i].y < points[j].y : points[i].x < points[j].x;
+    }
+    const std::vector<Pnt>& points;
+    bool yaxis;
+};
+
+// add point j to the k nearest points to point i so far, nearest first
+static void add_nearest(std::vector< std::pair<double, unsigned int> >& best, unsigned int k,
+                        const std::vector<Pnt>& points, unsigned int i, unsigned int j) {
+    if ( j == i )
+        return;
+    double d_sq = dist_sq( points[i], points[j] );
+    if ( best.size() == k ) {
+        if ( d_sq >= best.back().first )
+            return;
+        best.pop_back();
+    }
+    unsigned int m = best.size();
+    best.push_back( std::make_pair(d_sq, j) );
+    for ( ; m > 0 && best[m-1].first > d_sq; --m)
+        std::swap( best[m-1], best[m] );
+}
+
+void PointTree::build(const std::vector<Pnt>& pts, const std::vector<unsigned int>& idx) {
+    points = &pts;
+    items = idx;
+    slot.resize( pts.size() );
+    axis.assign( idx.size(), 0 );
+    count.assign( idx.size(), 0 );
+    alive.assign( idx.size(), 1 );
+    build( 0, items.size() );
+    for (unsigned int m=0; m<items.size(); ++m)
+        slot[ items[m] ] = m;
+}
+
+void PointTree::build(unsigned int lo, unsigned int hi) {
+    if ( lo >= hi )
+        return;
+    unsigned int mid = (lo+hi)/2;
+    count[mid] = hi-lo;
+    if ( hi-lo <= LEAF_SIZE )
+        return;
+    const std::vector<Pnt>& p = *points;
+    double x0 = p[ items[lo] ].x, x1 = x0;
+    double y0 = p[ items[lo] ].y, y1 = y0;
+    for (unsigned int m=lo+1; m<hi; ++m) {
+        x0 = std::min( x0, p[ items[m] ].x );
+        x1 = std::max( x1, p[ items[m] ].x );
+        y0 = std::min( y0, p[ items[m] ].y );
+        y1 = std::max( y1, p[ items[m] ].y );
+    }
+    axis[mid] = ( y1-y0 > x1-x0 );
+    std::nth_element( items.begin()+lo, items.begin()+mid, items.begin()+hi, AxisLess(p, axis[mid]) );
+    build( lo, mid );
+    build( mid+1, hi );
+}
+
+void PointTree::nearest(unsigned int i, unsigned int k, std::vector< std::pair<double, unsigned int> >& best) const {
+    nearest( 0, items.size(), i, k, best );
+}
+
+void PointTree::nearest(unsigned int lo, unsigned int hi, unsigned int i, unsigned int k,
+                        std::vector< std::pair<double, unsigned int> >& best) const {
+    if ( lo >= hi )
+        return;
+    const std::vector<Pnt>& p = *points;
+    unsigned int mid = (lo+hi)/2;
+    if ( hi-lo <= LEAF_SIZE ) {
+        for (unsigned int m=lo; m<hi; ++m)
+            add_nearest( best, k, p, i, items[m] );
+        return;
+    }
+    add_nearest( best, k, p, i, items[mid] );
+    double diff = axis[mid] ? p[i].y - p[ items[mid] ].y : p[i].x - p[ items[mid] ].x;
+    if ( diff < 0 ) {
+        nearest( lo, mid, i, k, best );
+        if ( best.size() < k || diff*diff < best.back().first )
+            nearest( mid+1, hi, i, k, best );
+    } else {
+        nearest( mid+1, hi, i, k, best );
+        if ( best.size() < k || diff*diff < best.back().first )
+            nearest( lo, mid, i, k, best );
+    }
+}
+
+unsigned int PointTree::nearest_live(const Pnt& q) const {
+    double best_sq = std::numeric_limits<double>::max();
+    unsigned int best = 0;
+    nearest_live( 0, items.size(), q, best_sq, best );
+    return best;
+}
+
+void PointTree::nearest_live(unsigned int lo, unsigned int hi, const Pnt& q,
+                             double& best_sq, unsigned int& best) const {
+    if ( lo >= hi || count[ (lo+hi)/2 ] == 0 )
+        return;
+    const std::vector<Pnt>& p = *points;
+    unsigned int mid = (lo+hi)/2;
+    if ( hi-lo <= LEAF_SIZE ) {
+        for (unsigned int m=lo; m<hi; ++m) {
+            if ( alive[m] && dist_sq( p[ items[m] ], q ) < best_sq ) {
+                best_sq = dist_sq( p[ items[m] ], q );
+                best = items[m];
+            }
+        }
+        return;
+    }
+    if ( alive[mid] && dist_sq( p[ items[mid] ], q ) < best_sq ) {
+        best_sq = dist_sq( p[ items[mid] ], q );
+        best = items[mid];
+    }
+    double diff = axis[mid] ? q.y - p[ items[mid] ].y : q.x - p[ items[mid] ].x;
+    if ( diff < 0 ) {
+        nearest_live( lo, mid, q, best_sq, best );
+        if ( diff*diff < best_sq )
+            nearest_live( mid+1, hi, q, best_sq, best );
+    } else {
+        nearest_live( mid+1, hi, q, best_sq, best );
+        if ( diff*diff < best_sq )
+            nearest_live( lo, mid, q, best_sq, best );
+    }
+}
+
+void PointTree::remove(unsigned int i) {
+    unsigned int s = slot[i];
+    alive[s] = 0;
+    unsigned int lo = 0, hi = items.size();
+    for (;;) {
+        unsigned int mid = (lo+hi)/2;
+        count[mid]--;
+        if ( hi-lo <= LEAF_SIZE || s == mid )
+            return;
+        if ( s < mid )
+            hi = mid;
+        else
+            lo = mid+1;
+    }
+}
+
+} // end ocl namespace
+// end file pointtree.cpp
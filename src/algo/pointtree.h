@@ -0,0 +1,68 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef POINT_TREE_H
+#define POINT_TREE_H
+
+#include <vector>
+
+#include <boost/graph/simple_point.hpp>
+
+namespace ocl {
+
+/// \brief a kd-tree of points in the XY-plane, kept as a permutation of the points
+///
+/// The points in the index range [lo,hi) are split at the point in the middle of the range,
+/// along the longer side of their bounding box. Ranges of a few points are leaves.
+struct PointTree {
+    /// build the tree of the points idx of pts. pts must outlive the tree
+    void build(const std::vector< boost::simple_point<double> >& pts, const std::vector<unsigned int>& idx);
+    /// the k nearest points to point i, nearest first, with their squared distances
+    void nearest(unsigned int i, unsigned int k, std::vector< std::pair<double, unsigned int> >& best) const;
+    /// the nearest point to p that has not been removed
+    unsigned int nearest_live(const boost::simple_point<double>& p) const;
+    /// remove point i from nearest_live()
+    void remove(unsigned int i);
+    /// the points
+    const std::vector< boost::simple_point<double> >* points;
+    /// the points of the tree, by range
+    std::vector<unsigned int> items;
+    /// the position of each point in items
+    std::vector<unsigned int> slot;
+    /// the axis of the range with its middle here, 0 for x and 1 for y
+    std::vector<char> axis;
+    /// the number of points left in the range with its middle here
+    std::vector<unsigned int> count;
+    /// false for removed items
+    std::vector<char> alive;
+protected:
+    /// build the range [lo,hi)
+    void build(unsigned int lo, unsigned int hi);
+    /// the nearest points to point i in [lo,hi)
+    void nearest(unsigned int lo, unsigned int hi, unsigned int i, unsigned int k,
+                 std::vector< std::pair<double, unsigned int> >& best) const;
+    /// the nearest point to p in [lo,hi) that is closer than best_sq
+    void nearest_live(unsigned int lo, unsigned int hi, const boost::simple_point<double>& p,
+                      double& best_sq, unsigned int& best) const;
+};
+
+} // end ocl namespace
+#endif
+// end file pointtree.h
@@ -0,0 +1,269 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+
+#include <boost/foreach.hpp>
+
+#include "tiledweave.h"
+
+namespace ocl
+{
+
+namespace weave2
+{
+
+TiledWeave::TiledWeave(unsigned int strips, unsigned int threads) {
+    nstrips = strips;
+    nthreads = threads;
+}
+
+void TiledWeave::addFiber(Fiber& f) {
+    if ( f.dir.xParallel() && !f.empty() ) {
+        xfibers.push_back(f);
+    } else if ( f.dir.yParallel() && !f.empty() ) {
+        yfibers.push_back(f);
+    } else if (!f.empty()) {
+        assert(0); // fiber must be either x or y
+    }
+}
+
+// the borders are half-way between two Y-fibers, so no Y-fiber is on a border.
+// Y-fibers with the same x-coordinate are in the same strip.
+void TiledWeave::make_strips() {
+    std::vector< std::pair<double, unsigned int> > ysorted; // (x-coordinate, y-fiber index)
+    for (unsigned int ny=0; ny<yfibers.size(); ++ny)
+        ysorted.push_back( std::make_pair( yfibers[ny].p1.x, ny ) );
+    std::sort( ysorted.begin(), ysorted.end() );
+    yrank.resize( yfibers.size() );
+    for (unsigned int k=0; k<ysorted.size(); ++k)
+        yrank[ ysorted[k].second ] = k;
+    borders.clear();
+    unsigned int b = 0; // the first Y-fiber of the current strip
+    for (unsigned int k=1; k<nstrips; ++k) {
+        unsigned int next = std::max( (unsigned int)( ( (unsigned long)k * ysorted.size() ) / nstrips ), b+1 );
+        for ( ; next < ysorted.size() ; ++next ) {
+            double border = 0.5*( ysorted[next-1].first + ysorted[next].first );
+            if ( (ysorted[next-1].first < border) && (border < ysorted[next].first) ) {
+                borders.push_back( border );
+                break;
+            }
+        }
+        if ( next >= ysorted.size() )
+            break;
+        b = next;
+    }
+    strips.assign( borders.size()+1, Strip() );
+    for (unsigned int ny=0; ny<yfibers.size(); ++ny) {
+        unsigned int s = std::upper_bound( borders.begin(), borders.end(), yfibers[ny].p1.x ) - borders.begin();
+        strips[s].yfiber.push_back( ny );
+    }
+}
+
+// an interval is in the strip of its lower end, and it is cut at every border strictly
+// inside it. The cut intervals keep the t-values of the X-fiber, so the CL-points at the
+// ends that are not cut are at the same positions as in one Weave.
+void TiledWeave::cut_xfibers() {
+    for (unsigned int nx=0; nx<xfibers.size(); ++nx) {
+        const Fiber& xf = xfibers[nx];
+        for (unsigned int mx=0; mx<xf.size(); ++mx) {
+            const Interval& xi = xf.ints[mx];
+            double xmin = xf.point(xi.lower).x;
+            double xmax = xf.point(xi.upper).x;
+            unsigned int s0 = std::upper_bound( borders.begin(), borders.end(), xmin ) - borders.begin();
+            unsigned int s1 = std::lower_bound( borders.begin(), borders.end(), xmax ) - borders.begin();
+            s1 = std::max( s0, s1 );
+            for (unsigned int s=s0; s<=s1; ++s) {
+                Strip& st = strips[s];
+                if ( st.xfiber.empty() || ( st.xfiber.back() != nx ) ) {
+                    st.xfibers.push_back( Fiber( xf.p1, xf.p2 ) );
+                    st.xfiber.push_back( nx );
+                    st.xoffset.push_back( mx );
+                    st.xcut.push_back( std::vector<char>() );
+                }
+                Interval piece( xi );
+                if ( s > s0 )
+                    piece.lower = ( borders[s-1] - xf.p1.x ) / ( xf.p2.x - xf.p1.x );
+                if ( s < s1 )
+                    piece.upper = ( borders[s] - xf.p1.x ) / ( xf.p2.x - xf.p1.x );
+                st.xfibers.back().ints.push_back( piece );
+                st.xcut.back().push_back( s > s0 );
+                st.xcut.back().push_back( s < s1 );
+            }
+        }
+    }
+}
+
+// the fibers are added in the order of TiledWeave, so the Weave adds the CL-vertices
+// of the strip in the same order as one Weave of all fibers.
+void TiledWeave::build_strip(Strip& s) const {
+    Weave w;
+    BOOST_FOREACH( Fiber& f, s.xfibers ) {
+        w.addFiber(f);
+    }
+    BOOST_FOREACH( unsigned int ny, s.yfiber ) {
+        Fiber f( yfibers[ny] );
+        w.addFiber(f);
+    }
+    w.build();
+    w.face_traverse();
+    s.loops = w.getLoopEnds();
+    s.clEnds = w.getCLEnds();
+}
+
+void TiledWeave::build() {
+    make_strips();
+    cut_xfibers();
+    std::cout << " TiledWeave::build() " << strips.size() << " strips\n";
+    int n;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) private(n)
+    for (n=0; n<(int)strips.size(); ++n) {
+        build_strip( strips[n] );
+    }
+    stitch();
+}
+
+/// a CL-point of a loop, with its order
+typedef std::pair<CLOrder, Point> LoopPoint;
+
+/// the part of a loop in one strip, between two cut ends of X-intervals
+struct LoopPiece {
+    /// the CL-points
+    std::vector<LoopPoint> points;
+    /// 0 when the piece ends at a cut lower end, 1 at a cut upper end
+    int end;
+    /// the cut end where the piece ends, as (border, X-fiber)
+    std::pair<unsigned int, unsigned int> cut;
+};
+
+// A walk that arrives at the cut upper end of an X-interval on border k continues along
+// the same X-interval in the next strip, from its cut lower end, and the other way around.
+// Cells inside the intervals that are cut by a border are also closed by the cut ends,
+// and these stitch into loops without CL-points, which are left out.
+// Weave::face_traverse() starts the loops at the CL-vertices in the order they were added,
+// so each loop is rotated to start at its first CL-point, and the loops are sorted.
+void TiledWeave::stitch() {
+    std::vector< std::vector<LoopPoint> > whole; // loops within one strip, and stitched loops
+    std::vector<LoopPiece> pieces;
+    std::map< std::pair<unsigned int, unsigned int>, unsigned int > starts[2]; // pieces that start at a cut lower [0] or upper [1] end
+    for (unsigned int ns=0; ns<strips.size(); ++ns) {
+        const Strip& st = strips[ns];
+        // the X-interval that each Y-interval was added with
+        std::vector< std::vector< std::pair<unsigned int, unsigned int> > > anchor( st.yfiber.size() );
+        for (unsigned int k=0; k<st.yfiber.size(); ++k)
+            anchor[k].resize( yfibers[ st.yfiber[k] ].size() );
+        std::pair<unsigned int, unsigned int> current( 0, 0 );
+        BOOST_FOREACH( const IntervalEnd& e, st.clEnds ) {
+            if ( e.axis == 0 )
+                current = std::make_pair( st.xfiber[e.fiber], st.xoffset[e.fiber] + e.interval );
+            else
+                anchor[e.fiber][e.interval] = current;
+        }
+        BOOST_FOREACH( const std::vector<IntervalEnd>& loop, st.loops ) {
+            std::vector<LoopPoint> points;
+            std::vector<unsigned int> cuts; // positions in points of the cut ends
+            BOOST_FOREACH( const IntervalEnd& e, loop ) {
+                CLOrder o;
+                Point p;
+                if ( e.axis == 0 ) {
+                    if ( st.xcut[e.fiber][2*e.interval+e.end] )
+                        cuts.push_back( points.size() );
+                    const Fiber& f = xfibers[ st.xfiber[e.fiber] ];
+                    const Interval& i = f.ints[ st.xoffset[e.fiber] + e.interval ];
+                    CLOrder xo = { st.xfiber[e.fiber], st.xoffset[e.fiber] + e.interval, 0, 0, 0, e.end };
+                    o = xo;
+                    p = f.point( (e.end == 0) ? i.lower : i.upper );
+                } else {
+                    unsigned int ny = st.yfiber[e.fiber];
+                    const Interval& i = yfibers[ny].ints[e.interval];
+                    const std::pair<unsigned int, unsigned int>& a = anchor[e.fiber][e.interval];
+                    CLOrder yo = { a.first, a.second, 1, yrank[ny], e.interval, e.end };
+                    o = yo;
+                    p = yfibers[ny].point( (e.end == 0) ? i.lower : i.upper );
+                }
+                points.push_back( std::make_pair( o, p ) );
+            }
+            if ( cuts.empty() ) {
+                whole.push_back( points );
+                continue;
+            }
+            for (unsigned int c=0; c<cuts.size(); ++c) { // one piece from each cut end to the next
+                unsigned int first = cuts[c];
+                unsigned int last = cuts[ (c+1) % cuts.size() ];
+                LoopPiece piece;
+                for (unsigned int m = (first+1) % points.size(); m != last; m = (m+1) % points.size())
+                    piece.points.push_back( points[m] );
+                const IntervalEnd& from = loop[first];
+                const IntervalEnd& to = loop[last];
+                piece.end = to.end;
+                piece.cut = std::make_pair( (to.end == 0) ? ns-1 : ns, st.xfiber[to.fiber] );
+                starts[from.end][ std::make_pair( (from.end == 0) ? ns-1 : ns, st.xfiber[from.fiber] ) ] = pieces.size();
+                pieces.push_back( piece );
+            }
+        }
+    }
+    std::vector<char> used( pieces.size(), 0 );
+    for (unsigned int n=0; n<pieces.size(); ++n) {
+        if ( used[n] )
+            continue;
+        std::vector<LoopPoint> points;
+        unsigned int current = n;
+        do { // follow the pieces across the borders
+            assert( !used[current] ); // each piece is in one loop only
+            used[current] = 1;
+            const LoopPiece& piece = pieces[current];
+            points.insert( points.end(), piece.points.begin(), piece.points.end() );
+            std::map< std::pair<unsigned int, unsigned int>, unsigned int >::const_iterator next;
+            next = starts[1-piece.end].find( piece.cut );
+            if ( next == starts[1-piece.end].end() ) { // the other end of the cut is in no loop, the loop can't be closed
+                std::cout << "ERROR: TiledWeave::stitch() no piece continues across border " << piece.cut.first;
+                std::cout << " along X-fiber " << piece.cut.second << ", an open loop is dropped.\n";
+                points.clear();
+                break;
+            }
+            current = next->second;
+        } while ( current != n );
+        if ( !points.empty() ) // a face inside the intervals, that crosses a border, has no CL-points
+            whole.push_back( points );
+    }
+    std::vector< std::pair<CLOrder, unsigned int> > order; // (first CL-point, loop)
+    for (unsigned int n=0; n<whole.size(); ++n) {
+        std::vector<LoopPoint>& loop = whole[n];
+        std::rotate( loop.begin(), std::min_element( loop.begin(), loop.end(), first_less<LoopPoint> ), loop.end() );
+        order.push_back( std::make_pair( loop[0].first, n ) );
+    }
+    std::sort( order.begin(), order.end(), first_less< std::pair<CLOrder, unsigned int> > );
+    loops.clear();
+    for (unsigned int n=0; n<order.size(); ++n) {
+        std::vector<Point> loop;
+        BOOST_FOREACH( const LoopPoint& p, whole[ order[n].second ] ) {
+            loop.push_back( p.second );
+        }
+        loops.push_back( loop );
+    }
+}
+
+} // end weave2 namespace
+
+} // end ocl namespace
+// end file tiledweave.cpp
@@ -0,0 +1,107 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TILEDWEAVE_H
+#define TILEDWEAVE_H
+
+#include <vector>
+
+#include "point.h"
+#include "fiber.h"
+#include "weave2.h"
+
+namespace ocl
+{
+
+namespace weave2
+{
+
+/// \brief a Weave built in strips, on separate threads
+///
+/// The XY-plane is divided along x into strips with about the same number of Y-fibers.
+/// Each strip has its own Weave, of the Y-fibers in the strip and the X-intervals cut at
+/// the strip borders, and the Weaves are built and traversed in parallel. A loop that crosses
+/// a border is traversed in pieces, which end at the cut ends of the X-intervals on the border.
+/// The pieces are stitched across the borders into the loops of the whole Weave.
+/// When the X-fibers are added in y-order, as Waterline does, the loops and their order are
+/// the same as from Weave::face_traverse().
+class TiledWeave {
+    public:
+        /// a weave in strips strips, built on nthreads threads
+        TiledWeave(unsigned int strips, unsigned int nthreads);
+        virtual ~TiledWeave() {}
+        /// add Fiber f. each fiber should be either in the X or Y-direction
+        void addFiber(Fiber& f);
+        /// build and traverse the Weave of each strip, and stitch the loops
+        void build();
+        /// return the list of loops
+        std::vector< std::vector<Point> > getLoops() const {return loops;}
+
+    protected:
+        /// the Fibers of one strip, and the loops of its Weave
+        struct Strip {
+            /// the cut X-fibers
+            std::vector<Fiber> xfibers;
+            /// the X-fiber of TiledWeave of each cut X-fiber
+            std::vector<unsigned int> xfiber;
+            /// the index of the first interval of each cut X-fiber in the X-fiber of TiledWeave
+            std::vector<unsigned int> xoffset;
+            /// two flags for each interval of the cut X-fibers, set when that end is on a border
+            std::vector< std::vector<char> > xcut;
+            /// the Y-fibers of TiledWeave in this strip
+            std::vector<unsigned int> yfiber;
+            /// the loops of the Weave of this strip
+            std::vector< std::vector<IntervalEnd> > loops;
+            /// the CL-vertices of the Weave of this strip, in the order Weave::build() added them
+            std::vector<IntervalEnd> clEnds;
+        };
+        /// the borders between the strips, and the Y-fibers of each strip
+        void make_strips();
+        /// cut the intervals of the X-fibers at the borders
+        void cut_xfibers();
+        /// build and traverse the Weave of strip s
+        void build_strip(Strip& s) const;
+        /// join the loops of the strips at the borders
+        void stitch();
+
+    // DATA
+        /// the X-fibers
+        std::vector<Fiber> xfibers;
+        /// the Y-fibers
+        std::vector<Fiber> yfibers;
+        /// the requested number of strips
+        unsigned int nstrips;
+        /// the number of threads
+        unsigned int nthreads;
+        /// the position of each Y-fiber in x-order
+        std::vector<unsigned int> yrank;
+        /// the x-coordinates of the borders between the strips
+        std::vector<double> borders;
+        /// the strips
+        std::vector<Strip> strips;
+        /// output: the loops
+        std::vector< std::vector<Point> > loops;
+};
+
+} // end weave2 namespace
+
+} // end ocl namespace
+#endif
+// end file tiledweave.h
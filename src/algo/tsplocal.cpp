@@ -0,0 +1,414 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <ctime>
+#include <deque>
+#include <limits>
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+#include "tsplocal.h"
+
+namespace ocl {
+
+namespace tsp {
+
+// the number of neighbors of each point, and how many of them give the edges of the greedy matching
+static const unsigned int NEIGHBORS = 8;
+static const unsigned int GREEDY_NEIGHBORS = 5;
+// the longest reversal of a move, in points. longer moves are skipped
+static const unsigned int MAX_REVERSE = 50000;
+// the smallest improvement of a move
+static const double MIN_GAIN = 1e-9;
+
+typedef boost::simple_point<double> Pnt;
+
+// a neighbor-edge for the greedy matching
+struct Candidate {
+    float d;
+    unsigned int a, b;
+};
+
+// compare candidates by length
+struct Shorter {
+    bool operator()(const Candidate& c1, const Candidate& c2) const {
+        return c1.d < c2.d;
+    }
+};
+
+// the root of the set of i, with path halving
+static unsigned int find_set(std::vector<unsigned int>& parent, unsigned int i) {
+    while ( parent[i] != i ) {
+        parent[i] = parent[ parent[i] ];
+        i = parent[i];
+    }
+    return i;
+}
+
+// the other end of the path in adj that ends at e
+static unsigned int path_end(const std::vector<int>& adj, unsigned int e) {
+    int prev = -1;
+    int cur = e;
+    for (;;) {
+        int a = adj[2*cur];
+        int b = adj[2*cur+1];
+        int nxt = ( a != -1 && a != prev ) ? a : ( ( b != -1 && b != prev ) ? b : -1 );
+        if ( nxt == -1 )
+            return cur;
+        prev = cur;
+        cur = nxt;
+    }
+}
+
+// connect i and j in adj
+static void link(std::vector<int>& adj, unsigned int i, unsigned int j) {
+    adj[ ( adj[2*i] == -1 ) ? 2*i : 2*i+1 ] = j;
+    adj[ ( adj[2*j] == -1 ) ? 2*j : 2*j+1 ] = i;
+}
+
+LocalTSPSolver::LocalTSPSolver() {
+    timeLimit = 10.0;
+    nthreads = 1;
+    nk = 0;
+    length = 0.0;
+}
+
+void LocalTSPSolver::addPoint(double x, double y) {
+    Pnt p;
+    p.x = x;
+    p.y = y;
+    points.push_back(p);
+}
+
+void LocalTSPSolver::reset() {
+    points.clear();
+    neighbors.clear();
+    tour.clear();
+    pos.clear();
+    output.clear();
+    length = 0.0;
+}
+
+double LocalTSPSolver::dist(unsigned int i, unsigned int j) const {
+    double dx = points[i].x - points[j].x;
+    double dy = points[i].y - points[j].y;
+    return sqrt( dx*dx + dy*dy );
+}
+
+void LocalTSPSolver::run() {
+    unsigned int n = points.size();
+    output.clear();
+    length = 0.0;
+    tour.resize(n);
+    for (unsigned int i=0; i<n; ++i)
+        tour[i] = i;
+    if ( n >= 4 ) { // three or fewer points have only one tour
+        PointTree tree;
+        tree.build( points, tour );
+        // number the points in the order of the tree, so that near points are near in memory
+        std::vector<unsigned int> order( tree.items );
+        std::vector<Pnt> input( n );
+        for (unsigned int i=0; i<n; ++i)
+            input[i] = points[ order[i] ];
+        points.swap( input );
+        for (unsigned int i=0; i<n; ++i)
+            tree.items[i] = tree.slot[i] = i;
+        find_neighbors( tree );
+        std::vector<int> adj( 2*n, -1 );
+        greedy_fragments( adj );
+        join_fragments( adj );
+        int prev = -1;
+        int cur = 0;
+        for (unsigned int i=0; i<n; ++i) {
+            tour[i] = cur;
+            int nxt = ( adj[2*cur] != prev ) ? adj[2*cur] : adj[2*cur+1];
+            prev = cur;
+            cur = nxt;
+        }
+        pos.resize(n);
+        for (unsigned int i=0; i<n; ++i)
+            pos[ tour[i] ] = i;
+        improve();
+        std::vector<unsigned int>().swap( neighbors );
+        points.swap( input );
+        for (unsigned int i=0; i<n; ++i)
+            tour[i] = order[ tour[i] ];
+    }
+    output = tour;
+    if ( n > 0 )
+        output.push_back( tour[0] );
+    for (unsigned int i=1; i<output.size(); ++i)
+        length += dist( output[i-1], output[i] );
+}
+
+void LocalTSPSolver::find_neighbors(const PointTree& tree) {
+    unsigned int n = points.size();
+    nk = std::min( NEIGHBORS, n-1 );
+    neighbors.resize( n*nk );
+    #pragma omp parallel num_threads(nthreads)
+    {
+    std::vector< std::pair<double, unsigned int> > best;
+    best.reserve( nk+1 );
+    int i;
+    #pragma omp for schedule(dynamic, 1024)
+    for (i=0; i< (int)n; ++i) {
+        best.clear();
+        tree.nearest( i, nk, best );
+        for (unsigned int m=0; m<nk; ++m)
+            neighbors[i*nk+m] = best[m].second;
+    }
+    }
+}
+
+void LocalTSPSolver::greedy_fragments(std::vector<int>& adj) const {
+    unsigned int n = points.size();
+    unsigned int kg = std::min( GREEDY_NEIGHBORS, nk );
+    std::vector<Candidate> cand;
+    cand.reserve( n*kg );
+    for (unsigned int i=0; i<n; ++i) {
+        for (unsigned int m=0; m<kg; ++m) {
+            unsigned int j = neighbors[i*nk+m];
+            // each edge once: from the lower index, or from j when i is not among the neighbors of j
+            bool mutual = false;
+            for (unsigned int l=0; l<kg; ++l)
+                mutual = mutual || ( neighbors[j*nk+l] == i );
+            if ( i < j || !mutual ) {
+                Candidate c;
+                c.d = (float) dist(i, j);
+                c.a = i;
+                c.b = j;
+                cand.push_back(c);
+            }
+        }
+    }
+    std::sort( cand.begin(), cand.end(), Shorter() );
+    std::vector<unsigned int> parent(n);
+    for (unsigned int i=0; i<n; ++i)
+        parent[i] = i;
+    for (unsigned int m=0; m<cand.size(); ++m) {
+        unsigned int a = cand[m].a;
+        unsigned int b = cand[m].b;
+        if ( adj[2*a+1] != -1 || adj[2*b+1] != -1 ) // a point of degree two
+            continue;
+        unsigned int ra = find_set( parent, a );
+        unsigned int rb = find_set( parent, b );
+        if ( ra == rb ) // would close a cycle
+            continue;
+        parent[ra] = rb;
+        link( adj, a, b );
+    }
+}
+
+void LocalTSPSolver::join_fragments(std::vector<int>& adj) const {
+    // the ends of the paths
+    std::vector<unsigned int> ends;
+    for (unsigned int i=0; i<points.size(); ++i) {
+        if ( adj[2*i+1] == -1 )
+            ends.push_back(i);
+    }
+    PointTree tree;
+    tree.build( points, ends );
+    unsigned int left = ends.size();
+    unsigned int first = ends[0];
+    unsigned int cur = first;
+    unsigned int prev_end = first;
+    for (;;) {
+        // remove both ends of the path that starts at cur, and continue from its other end
+        unsigned int other = path_end( adj, cur );
+        tree.remove( cur );
+        left--;
+        if ( other != cur ) {
+            tree.remove( other );
+            left--;
+        }
+        if ( cur != first )
+            link( adj, prev_end, cur );
+        prev_end = other;
+        if ( left == 0 )
+            break;
+        cur = tree.nearest_live( points[prev_end] );
+    }
+    link( adj, prev_end, first );
+}
+
+// wall-clock time in seconds. std::clock() counts the CPU-time of all threads of the process,
+// which is the wall-clock time only without OpenMP
+static double wall_time() {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double) std::clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+void LocalTSPSolver::improve() {
+    if ( tour.size() < 8 )
+        return;
+    const double t0 = wall_time();
+    std::deque<unsigned int> queue( tour.begin(), tour.end() );
+    std::vector<char> queued( tour.size(), 1 );
+    std::vector<unsigned int> touched;
+    unsigned int iter = 0;
+    while ( !queue.empty() ) {
+        if ( ( ++iter & 1023 ) == 0 && wall_time() - t0 > timeLimit )
+            break;
+        unsigned int a = queue.front();
+        queue.pop_front();
+        queued[a] = 0;
+        touched.clear();
+        if ( improve_point( a, touched ) ) {
+            BOOST_FOREACH( unsigned int t, touched ) {
+                if ( !queued[t] ) {
+                    queued[t] = 1;
+                    queue.push_back(t);
+                }
+            }
+        }
+    }
+}
+
+bool LocalTSPSolver::improve_point(unsigned int a, std::vector<unsigned int>& touched) {
+    unsigned int n = tour.size();
+    // 2-opt: replace a-an and c-cn with a-c and an-cn
+    for (int dir=0; dir<2; ++dir) {
+        unsigned int an = dir ? prev(a) : next(a);
+        double d1 = dist( a, an );
+        for (unsigned int m=0; m<nk; ++m) {
+            unsigned int c = neighbors[a*nk+m];
+            double g1 = d1 - dist( a, c );
+            if ( g1 <= MIN_GAIN )
+                break;
+            unsigned int cn = dir ? prev(c) : next(c);
+            if ( c == an || cn == a )
+                continue;
+            if ( g1 + dist( c, cn ) - dist( an, cn ) <= MIN_GAIN )
+                continue;
+            unsigned int s = dir ? span( c, an ) : span( an, c );
+            if ( std::min( s, n-s ) > MAX_REVERSE )
+                continue;
+            two_opt( a, an, c, cn );
+            touched.push_back(a);
+            touched.push_back(an);
+            touched.push_back(c);
+            touched.push_back(cn);
+            return true;
+        }
+    }
+    // Or-opt: move the segment s1-s2 of one to three points, from between p and nn to between x and y
+    for (int dir=0; dir<2; ++dir) {
+        unsigned int seg[3];
+        seg[0] = a;
+        for (unsigned int len=1; len<=3; ++len) {
+            if ( len > 1 )
+                seg[len-1] = dir ? prev( seg[len-2] ) : next( seg[len-2] );
+            unsigned int s1 = seg[0];
+            unsigned int s2 = seg[len-1];
+            unsigned int p = dir ? next(s1) : prev(s1);
+            unsigned int nn = dir ? prev(s2) : next(s2);
+            double g1 = dist( p, s1 ) + dist( s2, nn ) - dist( p, nn );
+            if ( g1 <= MIN_GAIN )
+                continue;
+            for (unsigned int e=0; e < ( (len == 1) ? 1u : 2u ); ++e) {
+                unsigned int s = e ? s2 : s1;
+                for (unsigned int m=0; m<nk; ++m) {
+                    unsigned int c = neighbors[s*nk+m];
+                    if ( dist( s, c ) >= g1 )
+                        break;
+                    if ( std::find( seg, seg+len, c ) != seg+len )
+                        continue;
+                    for (int side=0; side<2; ++side) {
+                        unsigned int x = c, y = c;
+                        if ( side == 0 )
+                            y = dir ? prev(c) : next(c);
+                        else
+                            x = dir ? next(c) : prev(c);
+                        if ( y == p || std::find( seg, seg+len, x ) != seg+len
+                                    || std::find( seg, seg+len, y ) != seg+len )
+                            continue;
+                        double d_xy = dist( x, y );
+                        double add_fwd = dist( x, s1 ) + dist( s2, y ) - d_xy;
+                        double add_rev = dist( x, s2 ) + dist( s1, y ) - d_xy;
+                        if ( g1 - std::min( add_fwd, add_rev ) <= MIN_GAIN )
+                            continue;
+                        unsigned int d = ( pos[s1] > pos[x] ) ? pos[s1] - pos[x] : pos[x] - pos[s1];
+                        if ( std::min( d, n-d ) > MAX_REVERSE )
+                            continue;
+                        // three 2-opt moves: p-x s1-y, then p-nn x-s2, then x-s1 s2-y
+                        two_opt( p, s1, x, y );
+                        two_opt( p, x, nn, s2 );
+                        if ( add_fwd <= add_rev )
+                            two_opt( x, s2, s1, y );
+                        touched.push_back(p);
+                        touched.push_back(nn);
+                        touched.push_back(s1);
+                        touched.push_back(s2);
+                        touched.push_back(x);
+                        touched.push_back(y);
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+unsigned int LocalTSPSolver::span(unsigned int i, unsigned int j) const {
+    return ( pos[j] >= pos[i] ) ? pos[j] - pos[i] + 1 : pos[j] + tour.size() - pos[i] + 1;
+}
+
+void LocalTSPSolver::two_opt(unsigned int a, unsigned int b, unsigned int c, unsigned int d) {
+    if ( next(a) == b )
+        reverse( b, c );
+    else
+        reverse( c, b );
+}
+
+void LocalTSPSolver::reverse(unsigned int i, unsigned int j) {
+    unsigned int n = tour.size();
+    unsigned int len = span( i, j );
+    if ( 2*len > n ) { // the rest of the tour is shorter, and reversing it gives the same tour
+        unsigned int ni = next(j);
+        unsigned int nj = prev(i);
+        i = ni;
+        j = nj;
+        len = n - len;
+    }
+    unsigned int pi = pos[i];
+    unsigned int pj = pos[j];
+    for (unsigned int m=0; m<len/2; ++m) {
+        std::swap( tour[pi], tour[pj] );
+        pos[ tour[pi] ] = pi;
+        pos[ tour[pj] ] = pj;
+        pi = ( pi+1 == n ) ? 0 : pi+1;
+        pj = ( pj == 0 ) ? n-1 : pj-1;
+    }
+}
+
+} // end tsp namespace
+
+} // end ocl namespace
+// end file tsplocal.cpp
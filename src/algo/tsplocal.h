@@ -0,0 +1,110 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TSP_LOCAL_H
+#define TSP_LOCAL_H
+
+#include <vector>
+
+#include <boost/graph/simple_point.hpp>
+
+#include "pointtree.h"
+
+namespace ocl {
+
+namespace tsp {
+
+/// \brief an approximate TSP tour of a large set of points in the XY-plane
+///
+/// TSPSolver connects all pairs of points, which limits it to a few thousand points.
+/// LocalTSPSolver only looks at the nearest neighbors of each point, found with a kd-tree.
+/// The tour starts from a greedy matching of the neighbor-edges, with the fragments joined
+/// nearest-end-first. It is improved with 2-opt and Or-opt moves to the neighbors,
+/// until no move improves it or the time limit is reached.
+/// Time and memory grow about linearly with the number of points.
+class LocalTSPSolver {
+public:
+    LocalTSPSolver();
+    virtual ~LocalTSPSolver() {}
+    /// add a point
+    void addPoint(double x, double y);
+    /// set the time limit of the improvement, in seconds of wall-clock time.
+    /// the neighbor search and the first tour are not limited, and usually take longer than the improvement
+    void setTimeLimit(double seconds) {timeLimit = seconds;}
+    /// set the number of threads that search for the neighbors
+    void setThreads(unsigned int n) {nthreads = n;}
+    /// find the tour
+    void run();
+    /// the tour, as indices of the points. as in TSPSolver the first point is repeated at the end
+    std::vector<unsigned int> getTour() const {return output;}
+    /// the length of the tour
+    double getLength() const {return length;}
+    /// remove all points
+    void reset();
+
+protected:
+    /// find the nearest neighbors of each point
+    void find_neighbors(const PointTree& tree);
+    /// match the shortest neighbor-edges into paths. adj has two neighbors of each point, or -1
+    void greedy_fragments(std::vector<int>& adj) const;
+    /// join the paths into a tour
+    void join_fragments(std::vector<int>& adj) const;
+    /// improve the tour with 2-opt and Or-opt moves
+    void improve();
+    /// try the moves that start at point a. return true if the tour changed
+    bool improve_point(unsigned int a, std::vector<unsigned int>& touched);
+    /// the distance between points i and j
+    double dist(unsigned int i, unsigned int j) const;
+    /// the next point in the tour
+    unsigned int next(unsigned int i) const {return tour[ (pos[i]+1 == tour.size()) ? 0 : pos[i]+1 ];}
+    /// the previous point in the tour
+    unsigned int prev(unsigned int i) const {return tour[ (pos[i] == 0) ? tour.size()-1 : pos[i]-1 ];}
+    /// the number of points from i to j along the tour
+    unsigned int span(unsigned int i, unsigned int j) const;
+    /// replace the edges a-b and c-d with a-c and b-d. b and d follow a and c in the same direction
+    void two_opt(unsigned int a, unsigned int b, unsigned int c, unsigned int d);
+    /// reverse the tour from i to j
+    void reverse(unsigned int i, unsigned int j);
+
+    /// the points
+    std::vector< boost::simple_point<double> > points;
+    /// the time limit of the improvement
+    double timeLimit;
+    /// the number of threads
+    unsigned int nthreads;
+    /// the number of neighbors of each point
+    unsigned int nk;
+    /// the nk nearest neighbors of each point, nearest first
+    std::vector<unsigned int> neighbors;
+    /// the tour
+    std::vector<unsigned int> tour;
+    /// the position of each point in the tour
+    std::vector<unsigned int> pos;
+    /// the output tour
+    std::vector<unsigned int> output;
+    /// the length of the tour
+    double length;
+};
+
+} // end tsp namespace
+
+} // end ocl namespace
+#endif
+// end file tsplocal.h
@@ -0,0 +1,52 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TSP_LOCAL_PY_H
+#define TSP_LOCAL_PY_H
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "tsplocal.h"
+
+namespace ocl {
+
+namespace tsp {
+
+/// python wrapper for LocalTSPSolver
+class LocalTSPSolver_py : public LocalTSPSolver {
+public:
+    LocalTSPSolver_py() : LocalTSPSolver() {}
+    /// return the tour to python
+    boost::python::list getOutput() const {
+        boost::python::list plist;
+        BOOST_FOREACH(unsigned int v, output) {
+            plist.append( v );
+        }
+        return plist;
+    }
+};
+
+} // end tsp namespace
+
+} // end ocl namespace
+#endif
+// end file tsplocal_py.h
@@ -18,6 +18,8 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+
 #include <boost/foreach.hpp> 
 
 #ifdef _OPENMP
@@ -31,8 +33,11 @@
 
 
 #include "batchpushcutter.h"
+#include "zslice.h"
 
 #include "weave2.h"
+#include "contourtracer.h"
+#include "tiledweave.h"
 
 namespace ocl
 {
@@ -48,10 +53,10 @@ Waterline::Waterline() {
     nthreads=1;
 #ifdef _OPENMP
     nthreads = omp_get_num_procs(); 
-    //omp_set_dynamic(0);
-    omp_set_nested(1);
 #endif
-
+    bucketSize = 1;
+    contourTracing = false;
+    weaveStrips = 1;
 }
 
 Waterline::~Waterline() {
@@ -74,8 +79,7 @@ Waterline::~Waterline() {
 // this will become the new faster version of the algorithm which uses Weave2
 void Waterline::run() {
     this->init_fibers();
-    subOp[0]->run(); // these two are independent, so could/should run in parallel
-    subOp[1]->run();
+    this->push_fibers( std::vector<double>(1, zh) );
     
     xfibers = *( subOp[0]->getFibers() );
     yfibers = *( subOp[1]->getFibers() );
@@ -83,13 +87,61 @@ void Waterline::run() {
     weave2_process();
 }
 
+// the X and Y push-cutters are independent, so their packets are all
+// distributed over one team of threads.
+// The ZSlice of each z-height is computed once and used by both push-cutters.
+// With several z-heights the slices are built in parallel, one per thread,
+// and a single slice uses all threads for its triangles.
+void Waterline::push_fibers(const std::vector<double>& zlevels) {
+    std::vector<double> z( zlevels );
+    std::sort( z.begin(), z.end() );
+    z.erase( std::unique( z.begin(), z.end() ), z.end() );
+    int Nz = z.size();
+    std::vector<ZSlice*> slices( Nz );
+    unsigned int slice_threads = ( Nz > 1 ) ? 1 : nthreads;
+    int k; // loop variable
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared(slices, z) private(k) if(Nz > 1)
+    for (k=0; k<Nz; ++k) {
+        slices[k] = new ZSlice();
+        slices[k]->build( *surf, cutter, z[k], slice_threads, bucketSize );
+    } // OpenMP parallel region ends here
+    std::vector<BatchPushCutter*> batches;
+    batches.push_back( static_cast<BatchPushCutter*>( subOp[0] ) );
+    batches.push_back( static_cast<BatchPushCutter*>( subOp[1] ) );
+    std::cout << "Waterline::push_fibers() " << batches[0]->getFibers()->size() << " X-fibers and ";
+    std::cout << batches[1]->getFibers()->size() << " Y-fibers\n";
+    BOOST_FOREACH( BatchPushCutter* b, batches ) {
+        b->setSlices( &slices );
+    }
+    BatchPushCutter::runBatches( batches, nthreads );
+    BOOST_FOREACH( BatchPushCutter* b, batches ) {
+        b->setSlices( NULL );
+    }
+    BOOST_FOREACH( ZSlice* slice, slices ) {
+        delete slice;
+    }
+}
+
 void Waterline::weave2_process() {
+    weave2_process( xfibers, yfibers, loops, nthreads );
+}
+
+void Waterline::weave2_process(const std::vector<Fiber>& xf, const std::vector<Fiber>& yf, 
+                               std::vector< std::vector<Point> >& out, unsigned int threads) const {
+    if ( contourTracing ) {
+        contour_process( xf, yf, out );
+        return;
+    }
+    if ( weaveStrips > 1 ) {
+        tiled_process( xf, yf, out, threads );
+        return;
+    }
     std::cout << "Weave2..." << std::flush;
     weave2::Weave w;
-    BOOST_FOREACH( Fiber f, xfibers ) {
+    BOOST_FOREACH( Fiber f, xf ) {
         w.addFiber(f);
     }
-    BOOST_FOREACH( Fiber f, yfibers ) {
+    BOOST_FOREACH( Fiber f, yf ) {
         w.addFiber(f);
     }
    
@@ -102,12 +154,52 @@ void Waterline::weave2_process() {
     std::cout << "get_loops()\n";
     std::vector< std::vector<Point> > weave_loops = w.getLoops();
     BOOST_FOREACH( std::vector<Point> loop, weave_loops ) {
-        this->loops.push_back( loop );
+        out.push_back( loop );
     }
     std::cout << "DONE get_loops()\n";   
 }
 
+// the ContourTracer only keeps the fibers and one flag per cl-point,
+// and visits only the crossings along the loops
+void Waterline::contour_process(const std::vector<Fiber>& xf, const std::vector<Fiber>& yf, 
+                                std::vector< std::vector<Point> >& out) const {
+    std::cout << "ContourTracer..." << std::flush;
+    weave2::ContourTracer t;
+    BOOST_FOREACH( Fiber f, xf ) {
+        t.addFiber(f);
+    }
+    BOOST_FOREACH( Fiber f, yf ) {
+        t.addFiber(f);
+    }
+    std::cout << "trace()\n";
+    t.trace();
+    std::cout << "DONE trace()\n";
+    std::vector< std::vector<Point> > traced_loops = t.getLoops();
+    BOOST_FOREACH( std::vector<Point> loop, traced_loops ) {
+        out.push_back( loop );
+    }
+}
+
 
+// the strips are built on threads threads
+void Waterline::tiled_process(const std::vector<Fiber>& xf, const std::vector<Fiber>& yf, 
+                              std::vector< std::vector<Point> >& out, unsigned int threads) const {
+    std::cout << "TiledWeave..." << std::flush;
+    weave2::TiledWeave w( weaveStrips, threads );
+    BOOST_FOREACH( Fiber f, xf ) {
+        w.addFiber(f);
+    }
+    BOOST_FOREACH( Fiber f, yf ) {
+        w.addFiber(f);
+    }
+    std::cout << "build()\n";
+    w.build();
+    std::cout << "DONE build()\n";
+    std::vector< std::vector<Point> > tiled_loops = w.getLoops();
+    BOOST_FOREACH( std::vector<Point> loop, tiled_loops ) {
+        out.push_back( loop );
+    }
+}
 
 void Waterline::init_fibers() {
     std::cout << " Waterline::init_fibers()\n";
@@ -25,6 +25,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/foreach.hpp>
+
 #include "point.h"
 #include "fiber.h"
 #include "batchpushcutter.h"
@@ -43,7 +45,9 @@ class MillingCutter;
 
 /// The Waterline object is used for generating waterline or z-slice toolpaths
 /// from an STL-model. Waterline uses two BatchPushCutter sub-operations to find out where the CL-points are located
-/// and a Weave to split and order the CL-points correctly into loops.
+/// and a Weave to split and order the CL-points correctly into loops. Alternatively a ContourTracer
+/// traces the same loops from the fibers, without building the Weave graph, or a TiledWeave
+/// builds the Weave in strips on separate threads.
 class Waterline : public Operation {
     public:
         /// create an empty Waterline object
@@ -54,6 +58,23 @@ class Waterline : public Operation {
         void setZ(const double z) {
             zh = z;
         }
+        /// set the fiber segment length of the push-cutter kd-tree searches, 
+        /// see BatchPushCutter::setSegmentLength(). must be called before setSTL()
+        void setSegmentLength(double l) {
+            BOOST_FOREACH(Operation* op, subOp) {
+                op->setSegmentLength(l);
+            }
+        }
+        /// trace the loops directly from the fibers with a weave2::ContourTracer (true), 
+        /// or from the graph of a weave2::Weave (false, the default). both give the same loops.
+        void setContourTracing(bool t) {
+            contourTracing = t;
+        }
+        /// build the weave in n strips, on separate threads, with a weave2::TiledWeave.
+        /// n=1, the default, builds one weave2::Weave. both give the same loops.
+        void setWeaveStrips(unsigned int n) {
+            weaveStrips = n;
+        }
         /// run the Waterline algorithm. setSTL, setCutter, setSampling, and setZ must
         /// be called before a call to run()
         virtual void run();
@@ -64,16 +85,36 @@ class Waterline : public Operation {
         }
         
     protected:
-        /// from xfibers and yfibers, build the weave, run face-traverse, and write toolpaths to loops
+        /// from xfibers and yfibers, build the weave, run face-traverse, and write toolpaths to loops.
+        /// with setContourTracing(true) this calls contour_process(), and with setWeaveStrips(n>1) 
+        /// tiled_process() instead
         void weave2_process(); 
+        /// as weave2_process(), from the fibers xf and yf, appending the loops to out.
+        /// only reads the members, so separate fiber sets can be processed on separate threads.
+        /// a TiledWeave builds its strips on at most threads threads
+        void weave2_process(const std::vector<Fiber>& xf, const std::vector<Fiber>& yf, 
+                            std::vector< std::vector<Point> >& out, unsigned int threads) const;
+        /// from xf and yf, build the weave in strips with a TiledWeave, and append toolpaths to out
+        void tiled_process(const std::vector<Fiber>& xf, const std::vector<Fiber>& yf, 
+                           std::vector< std::vector<Point> >& out, unsigned int threads) const;
+        /// from xf and yf, trace the loops with a ContourTracer, and append toolpaths to out
+        void contour_process(const std::vector<Fiber>& xf, const std::vector<Fiber>& yf, 
+                             std::vector< std::vector<Point> >& out) const;
         /// initialization of fibers
         void init_fibers();
+        /// run the X- and Y-fiber push-cutters as one parallel workload,
+        /// against the ZSlices of the z-heights zlevels
+        void push_fibers(const std::vector<double>& zlevels);
         /// x and y-coordinates for fiber generation
         std::vector<double> generate_range( double start, double end, int N) const;
         
     // DATA
         /// the z-height for this Waterline
         double zh;
+        /// flag for contour_process()
+        bool contourTracing;
+        /// the number of strips for tiled_process()
+        unsigned int weaveStrips;
         /// the results of this operation, a list of loops
         std::vector< std::vector<Point> >  loops; // change to CLPoint ?
         
@@ -25,6 +25,7 @@
 #include <boost/foreach.hpp>
 
 #include "waterline.h"
+#include "array_py.h"
 
 namespace ocl
 {
@@ -48,6 +49,10 @@ class Waterline_py : public Waterline {
             }
             return loop_list;
         }
+        /// return the loops to python as Arrays, see loop_arrays()
+        boost::python::tuple getLoopArrays() const {
+            return loop_arrays( loops );
+        }
         /// return a list of yfibers to python
         boost::python::list py_getXFibers() const {
             boost::python::list flist;
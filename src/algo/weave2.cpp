@@ -18,6 +18,9 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <iterator>
+
 #include "weave2.h"
 
 
@@ -27,13 +30,13 @@ namespace ocl
 namespace weave2
 {
 
-int VertexProps::count = 0;
-
 void Weave::addFiber(Fiber& f) {
     if ( f.dir.xParallel() && !f.empty() ) {
         xfibers.push_back(f);
+        xprops.push_back( std::vector<IntervalProps>( f.size() ) );
     } else if ( f.dir.yParallel() && !f.empty() ) {
         yfibers.push_back(f);
+        yprops.push_back( std::vector<IntervalProps>( f.size() ) );
     } else if (!f.empty()) {
         assert(0); // fiber must be either x or y
     }
@@ -41,44 +44,63 @@ void Weave::addFiber(Fiber& f) {
 
 // traverse the graph putting loops of vertices into the loops variable
 // this figure illustrates next-pointers: http://www.anderswallin.net/wp-content/uploads/2011/05/weave2_zoom.png
+// loops are started at cl-vertices in the order they were added, so the loops don't
+// depend on where the graph was allocated in memory.
 void Weave::face_traverse() { 
     std::cout << " traversing graph with " << clVertices.size() << " cl-points\n";
-    while ( !clVertices.empty() ) { // while unprocessed cl-vertices remain
+    BOOST_FOREACH( Vertex first, clVertices ) {
+        if ( g[first].type != CL ) // already in a loop
+            continue;
         std::vector<Vertex> loop; // start on a new loop
-        Vertex current = *(clVertices.begin());
-        Vertex first = current;
+        Vertex current = first;
         
         do { // traverse around the loop
             assert( g[current].type == CL ); // we only want cl-points in the loop
             loop.push_back(current);
-            clVertices.erase(current); // remove from list of unprocesser cl-verts
-            std::vector<Edge> outEdges = hedi::out_edges(current, g); // find the edge to follow
-            //if (outEdges.size() != 1 )
-            //    std::cout << " outEdges.size() = " << outEdges.size() << "\n";
-            assert( outEdges.size() == 1 ); // cl-points are allways at ends of intervals, so they have only one out-edge
-            Edge currentEdge = outEdges[0]; 
+            g[current].type = CL_DONE; // mark as processed
+            OutEdgeItr it, it_end;
+            boost::tie( it, it_end ) = hedi::out_edges(current, g); // find the edge to follow
+            assert( std::distance( it, it_end ) == 1 ); // cl-points are allways at ends of intervals, so they have only one out-edge
+            Edge currentEdge = *it; 
             do { // following next, find a CL point 
                 current = hedi::target( currentEdge, g);
                 currentEdge = g[currentEdge].next;
-            } while ( g[current].type != CL );
+            } while ( g[current].type == INT );
         } while (current!=first); // end the loop when we arrive at the start
         
         loops.push_back(loop); // add the processed loop to the master list of all loops
     }
+    clVertices.clear();
 }
         
 // add a new CL-vertex to Weave, also adding it to the interval intersection-set, and to clVertices
-Vertex Weave::add_cl_vertex( Point& position, Interval& ival, double ipos) {
-    Vertex  v = hedi::add_vertex( VertexProps( position, CL ), g);
-    ival.intersections2.insert( VertexPair( v, ipos) ); // ?? this makes Interval depend on the WeaveGraph type
-    clVertices.insert(v);
+// vertices are numbered by this Weave, so Weaves can be built concurrently on separate threads
+Vertex Weave::add_cl_vertex( Point& position, IntervalProps& ival, double ipos, const IntervalEnd& e) {
+    int index = boost::num_vertices( g );
+    Vertex  v = hedi::add_vertex( VertexProps( position, CL, index ), g);
+    ival.intersections.insert( VertexPair( v, ipos) );
+    clVertices.push_back(v);
+    clEnds.push_back( std::make_pair( index, e ) );
     return v;
 }
 
+// compare the vertex index of a pair in clEnds with an index, for std::lower_bound
+static bool index_below(const std::pair<int, IntervalEnd>& p, int index) {
+    return p.first < index;
+}
+
+// clEnds is sorted by vertex index, since the vertices are numbered in the order they are added
+IntervalEnd Weave::cl_end(Vertex v) const {
+    std::vector< std::pair<int, IntervalEnd> >::const_iterator it;
+    it = std::lower_bound( clEnds.begin(), clEnds.end(), g[v].index, index_below );
+    assert( (it != clEnds.end()) && (it->first == g[v].index) ); // v must be a CL-vertex
+    return it->second;
+}
+
 // given a VertexPair and an Interval, in the Interval find the Vertex above and below the given vertex
-std::pair<Vertex,Vertex> Weave::find_neighbor_vertices( VertexPair v_pair, Interval& ival) { 
-    VertexPairIterator itr = ival.intersections2.lower_bound( v_pair ); // returns first that is not less than argument (equal or greater)
-    assert( itr != ival.intersections2.end() ); // we must find a lower_bound
+std::pair<Vertex,Vertex> Weave::find_neighbor_vertices( VertexPair v_pair, IntervalProps& ival) { 
+    VertexPairIterator itr = ival.intersections.lower_bound( v_pair ); // returns first that is not less than argument (equal or greater)
+    assert( itr != ival.intersections.end() ); // we must find a lower_bound
     VertexPairIterator v_above = itr; // lower_bound returns one beyond the give key, i.e. what we want
     VertexPairIterator v_below = --itr; // this is the vertex below the give vertex
     std::pair<Vertex,Vertex> out;
@@ -86,162 +108,41 @@ std::pair<Vertex,Vertex> Weave::find_neighbor_vertices( VertexPair v_pair, Inter
     out.second = v_below->first; // vertex below v (xl)
     return out;
 }
-                            
+
 // from the list of fibers, build a graph
-// FIXME: the problem here is that from N x-fibers and N y-fibers
-// this builds a graph with roughly N*N vertices/edges. This consumes a lot of RAM even
-// for small parts, and unacceptably much RAM for large parts.
-// a smarter build() would keep track of the important faces of the planar graph
-// (faces that produce toolpath-loops)
-// vertices/edges belonging to non-toolpath-producing faces could then be deleted
-// and the RAM consumption should be limited to N+N (i.e. the length/perimeter of the part/toolpath
-// in contrast to the area for the naive implementation)
-void Weave::build() {
-    // 1) add CL-points of X-fiber (if not already in graph)
-    // 2) add CL-points of Y-fiber (if not already in graph)
-    // 3) add intersection point (if not already in graph) (will allways be new??)
-    // 4) add edges. (if they provide new connections)
-    //      ycl_lower <-> intp <-> ycl_upper
-    //      xcl_lower <-> intp <-> xcl_upper
-    // if this connects points that are already connected, then remove old edge and
-    // provide this "via" connection
-    //int n_xfiber=0;
-    BOOST_FOREACH( Fiber& xf, xfibers) {
+// from N x-fibers and N y-fibers this builds the full graph, with an intersection vertex for
+// every crossing of an x-interval and a y-interval, i.e. roughly N*N vertices/edges.
+// build1() and build2() are kept as references. build(), i.e. build3(), leaves out the
+// intersections inside the part, and its graph grows with the length of the loops.
+//
+// 1) add CL-points of X-fiber (if not already in graph)
+// 2) add CL-points of Y-fiber (if not already in graph)
+// 3) add intersection point (if not already in graph) (will allways be new??)
+// 4) add edges. (if they provide new connections)
+//      ycl_lower <-> intp <-> ycl_upper
+//      xcl_lower <-> intp <-> xcl_upper
+// if this connects points that are already connected, then remove old edge and
+// provide this "via" connection
+void Weave::build1() {
+    for (unsigned int nx=0; nx<xfibers.size(); ++nx) {
+        Fiber& xf = xfibers[nx];
         assert( !xf.empty() ); // no empty fibers please
-        BOOST_FOREACH( Interval& xi, xf.ints ) {
-            //std::cout << "x-fiber " << n_xfiber++ << "\n";
+        for (unsigned int mx=0; mx<xf.size(); ++mx) {
+            Interval& xi = xf.ints[mx];
             double xmin = xf.point(xi.lower).x;
             double xmax = xf.point(xi.upper).x;
-            assert( !xi.in_weave ); // this is the first time the x-interval is added!
-            xi.in_weave = true;
-            // add the X interval end-points to the weave
-            Point p1( xf.point(xi.lower) );
-            Vertex xv1 = add_cl_vertex( p1, xi, p1.x ); 
-            Point p2( xf.point(xi.upper) );
-            Vertex xv2 = add_cl_vertex( p2, xi, p2.x );
-            Edge e1 = hedi::add_edge( xv1, xv2, g);
-            Edge e2 = hedi::add_edge( xv2, xv1, g);
-
-            //std::cout << " add_edge " << v1 << "("<< p1.x<< ") - " << v2 <<"("<< p2.x << ")\n";
-            g[e1].next = e2;
-            g[e2].next = e1;
-            g[e1].prev = e2;
-            g[e2].prev = e1;
-            
-            BOOST_FOREACH( Fiber& yf, yfibers ) { // loop through all y-fibers for all x-intervals
+            add_x_interval( nx, mx );
+            for (unsigned int ny=0; ny<yfibers.size(); ++ny) { // loop through all y-fibers for all x-intervals
+                Fiber& yf = yfibers[ny];
                 if ( (xmin <= yf.p1.x) && ( yf.p1.x <= xmax ) ) {// potential intersection between y-fiber and x-interval
-                    BOOST_FOREACH( Interval& yi, yf.ints ) {
+                    for (unsigned int my=0; my<yf.size(); ++my) {
+                        Interval& yi = yf.ints[my];
                         double ymin = yf.point(yi.lower).y ;
                         double ymax = yf.point(yi.upper).y ;
                         if ( (ymin <= xf.p1.y) && (xf.p1.y <= ymax) ) { 
                             // there is an actual intersection btw x-interval and y-interval
-                            // X interval xi on fiber xf intersects with Y interval yi on fiber yf
-                            // intersection is at ( yf.p1.x, xf.p1.y , xf.p1.z )
-                            if (!yi.in_weave) { // add y-interval endpoints to weave
-                                Point p1( yf.point(yi.lower) );
-                                add_cl_vertex( p1, yi, p1.y );
-                                Point p2( yf.point(yi.upper) );
-                                add_cl_vertex( p2, yi, p2.y );
-                                yi.in_weave = true;
-                            }
-                            // 3) intersection point, of type INT
-                            Point v_position( yf.p1.x, xf.p1.y , xf.p1.z );
-                            Vertex v = hedi::add_vertex( VertexProps( v_position, INT ), g);
-                            
-                            // 4) add edges 
-                            
-                            // find x-neighbors
-                            Vertex x_u, x_l;
-                            boost::tie( x_u, x_l ) = find_neighbor_vertices( VertexPair(v, v_position.x) , xi); 
-                            
-                            // these original edges will eventually be deleted!
-                            Edge xe_lu = hedi::edge( x_l, x_u, g);
-                            Edge xe_ul = hedi::edge( x_u, x_l, g);
-                            Edge xe_lu_next = g[xe_lu].next;
-                            Edge xe_lu_prev = g[xe_lu].prev; 
-                            Edge xe_ul_next = g[xe_ul].next;
-                            Edge xe_ul_prev = g[xe_ul].prev; 
-                            
-                            // find y-neighbors
-                            Vertex y_u, y_l;
-                            boost::tie( y_u, y_l ) = find_neighbor_vertices( VertexPair(v, v_position.y) , yi); 
-                            
-                            // the next/prev data we need
-                            Edge ye_lu, ye_ul;
-                            Edge ye_lu_next, ye_lu_prev ;
-                            Edge ye_ul_next, ye_ul_prev ;
-             
-                            bool y_lu_edge = hedi::has_edge( y_l, y_u, g ); // flag indicating existing y_l - y_u edge 
-                            // the case where y_l and y_u are alread already connected.
-                            if ( y_lu_edge ) {
-                                //assert( hedi::has_edge( y_u, y_l, g ) ); // twin must also exist
-                                ye_lu = hedi::edge( y_l, y_u, g);
-                                ye_ul = hedi::edge( y_u, y_l, g);
-                                ye_lu_next = g[ye_lu].next;
-                                ye_lu_prev = g[ye_lu].prev; // hedi::previous_edge( ye_lu, g );
-                                ye_ul_next = g[ye_ul].next;
-                                ye_ul_prev = g[ye_ul].prev; // hedi::previous_edge( ye_ul, g );
-                            } 
-                            // and now eight new edges to add
-                            Edge xl_v = hedi::add_edge(x_l, v  , g);
-                            Edge v_yl = hedi::add_edge(v  , y_l, g);
-                            Edge yl_v = hedi::add_edge(y_l, v  , g);
-                            Edge v_xu = hedi::add_edge(v  , x_u, g);
-                            Edge xu_v = hedi::add_edge(x_u, v  , g);
-                            Edge v_yu = hedi::add_edge(v  , y_u, g);
-                            Edge yu_v = hedi::add_edge(y_u, v  , g);
-                            Edge v_xl = hedi::add_edge(v  , x_l, g);
-                            // checks for special cases:
-                            if (xe_lu_prev == xe_ul) // xl hairpin
-                                xe_lu_prev = v_xl;
-                            if (xe_lu_next == xe_ul) // xu hairpin
-                                xe_lu_next = xu_v;
-                            if (xe_ul_prev == xe_lu)
-                                xe_ul_prev = v_xu;
-                            if (xe_ul_next == xe_lu)
-                                xe_ul_next = xl_v;
-                            if ( y_lu_edge ) {
-                                // the same checks for the y-edge
-                                if (ye_lu_prev == ye_ul)
-                                    ye_lu_prev = v_yl;
-                                if (ye_lu_next == ye_ul)
-                                    ye_lu_next = yu_v;
-                                if (ye_ul_prev == ye_lu)
-                                    ye_ul_prev = v_yu;
-                                if (ye_ul_next == ye_lu)
-                                    ye_ul_next = yl_v;
-                            } else { // we should form a y-hairpin
-                                ye_lu_next = yu_v;
-                                ye_lu_prev = v_yl;
-                                ye_ul_next = yl_v;
-                                ye_ul_prev = v_yu;
-                            }
-                            // now set next/prev edges (there are 2*12=24 of these to do)
-                            g[xe_lu_prev].next = xl_v;  g[xl_v].prev = xe_lu_prev;
-                            g[xl_v].next = v_yl;        g[v_yl].prev = xl_v;
-                            g[v_yl].next = ye_ul_next;  g[ye_ul_next].prev = v_yl;
-                            g[ye_lu_prev].next = yl_v;  g[yl_v].prev = ye_lu_prev;
-                            g[yl_v].next = v_xu;        g[v_xu].prev = yl_v;
-                            g[v_xu].next = xe_lu_next;  g[xe_lu_next].prev = v_xu;
-                            g[xe_ul_prev].next = xu_v;  g[xu_v].prev = xe_ul_prev;
-                            g[xu_v].next = v_yu;        g[v_yu].prev = xu_v;
-                            g[v_yu].next = ye_lu_next;  g[ye_lu_next].prev = v_yu;
-                            g[ye_ul_prev].next = yu_v;  g[yu_v].prev = ye_ul_prev;
-                            g[yu_v].next = v_xl;        g[v_xl].prev = yu_v;
-                            g[v_xl].next = xe_ul_next;  g[xe_ul_next].prev = v_xl;
-                            // delete the old edges
-                            boost::remove_edge( x_l, x_u, g);
-                            boost::remove_edge( x_u, x_l, g);
-                            if ( y_lu_edge ) {
-                                boost::remove_edge( y_l, y_u, g);
-                                boost::remove_edge( y_u, y_l, g);
-                            }
-                            
-                            // finally add new intersection vertex to the interval sets
-                            xi.intersections2.insert( VertexPair( v, v_position.x ) );
-                            yi.intersections2.insert( VertexPair( v, v_position.y ) );
-
-                        } // end intersection case
+                            add_intersection( nx, mx, ny, my );
+                        }
                     } // end y interval loop
                 } // end if(potential intersection)
             } // end y fiber loop
@@ -249,6 +150,241 @@ void Weave::build() {
     } // end X-fiber loop
 }
 
+// the same graph as build1(), without testing every y-fiber against every x-interval.
+// The y-fibers are sorted by x-coordinate, and the y-fibers that cross an x-interval 
+// are found by binary search. The intervals of a fiber are sorted, so the y-interval 
+// that can contain the x-fiber is found by binary search on its t-value.
+// The tolerance on t only widens the search, the intersection test is the same as in build1().
+// y-fibers with equal x-coordinate keep their order, so when the y-fibers are added in x-order,
+// as Waterline does, the intersections are added in the same order as in build1().
+void Weave::build2() {
+    build_sorted( false );
+}
+
+// The cells of the weave are the rectangles between neighbouring x- and y-fibers.
+// An intersection vertex whose four cells are all covered by intervals is surrounded
+// by faces without cl-vertices, and face_traverse() never visits it. build3() leaves these
+// vertices out, so the graph only holds the vertices near the loops.
+// Every vertex that face_traverse() visits has the same neighbors in all four directions
+// as in the full graph, so the loops are the same as from build2().
+void Weave::build3() {
+    build_sorted( true );
+}
+
+void Weave::build_sorted(bool compact) {
+    std::vector< std::pair<double, unsigned int> > ysorted; // (x-coordinate, y-fiber index)
+    for (unsigned int ny=0; ny<yfibers.size(); ++ny)
+        ysorted.push_back( std::make_pair( yfibers[ny].p1.x, ny ) );
+    std::sort( ysorted.begin(), ysorted.end() ); // ties are sorted by index, i.e. build1() order
+    std::vector< std::pair<double, unsigned int> > xsorted; // (y-coordinate, x-fiber index)
+    for (unsigned int nx=0; nx<xfibers.size(); ++nx)
+        xsorted.push_back( std::make_pair( xfibers[nx].p1.y, nx ) );
+    std::sort( xsorted.begin(), xsorted.end() );
+    std::vector<unsigned int> xrank( xfibers.size() ); // position of each x-fiber in xsorted
+    for (unsigned int k=0; k<xsorted.size(); ++k)
+        xrank[ xsorted[k].second ] = k;
+    const double t_tol = 1E-9;
+    for (unsigned int nx=0; nx<xfibers.size(); ++nx) {
+        Fiber& xf = xfibers[nx];
+        assert( !xf.empty() ); // no empty fibers please
+        for (unsigned int mx=0; mx<xf.size(); ++mx) {
+            Interval& xi = xf.ints[mx];
+            double xmin = xf.point(xi.lower).x;
+            double xmax = xf.point(xi.upper).x;
+            add_x_interval( nx, mx );
+            std::vector< std::pair<double, unsigned int> >::iterator it;
+            it = std::lower_bound( ysorted.begin(), ysorted.end(), std::make_pair( xmin, 0u ) );
+            for ( ; (it != ysorted.end()) && (it->first <= xmax) ; ++it ) { // y-fibers with xmin <= x <= xmax
+                unsigned int ny = it->second;
+                if ( compact && inside( xsorted, xrank[nx], ysorted, it - ysorted.begin() ) )
+                    continue;
+                Fiber& yf = yfibers[ny];
+                double t = ( xf.p1.y - yf.p1.y ) / ( yf.p2.y - yf.p1.y ); // the x-fiber on the y-fiber
+                std::vector<Interval>::iterator yi_it;
+                yi_it = std::lower_bound( yf.ints.begin(), yf.ints.end(), t-t_tol, upper_below );
+                for ( ; (yi_it != yf.ints.end()) && (yi_it->lower <= t+t_tol) ; ++yi_it ) {
+                    double ymin = yf.point(yi_it->lower).y ;
+                    double ymax = yf.point(yi_it->upper).y ;
+                    if ( (ymin <= xf.p1.y) && (xf.p1.y <= ymax) ) 
+                        add_intersection( nx, mx, ny, yi_it - yf.ints.begin() );
+                }
+            }
+        }
+    }
+}
+
+// true if the intersection of x-fiber xsorted[a] and y-fiber ysorted[b] is surrounded by
+// four cells covered by intervals: the x-fibers a-1, a, a+1 have one interval each reaching 
+// from y-fiber b-1 to y-fiber b+1, and the y-fibers b-1, b, b+1 from x-fiber a-1 to x-fiber a+1.
+bool Weave::inside(const std::vector< std::pair<double, unsigned int> >& xsorted, unsigned int a,
+                   const std::vector< std::pair<double, unsigned int> >& ysorted, unsigned int b) const {
+    if ( (a == 0) || (a+1 >= xsorted.size()) || (b == 0) || (b+1 >= ysorted.size()) )
+        return false; // on the border of the weave
+    for (unsigned int k=a-1; k<=a+1; ++k) {
+        if ( !covers( xfibers[ xsorted[k].second ], true, ysorted[b-1].first, ysorted[b+1].first ) )
+            return false;
+    }
+    for (unsigned int k=b-1; k<=b+1; ++k) {
+        if ( !covers( yfibers[ ysorted[k].second ], false, xsorted[a-1].first, xsorted[a+1].first ) )
+            return false;
+    }
+    return true;
+}
+
+// the interval end-points are compared as in build1(), the t-values only locate the interval
+bool Weave::covers(const Fiber& f, bool xfiber, double c0, double c1) const {
+    const double t_tol = 1E-9;
+    double t0 = xfiber ? ( c0 - f.p1.x ) / ( f.p2.x - f.p1.x ) : ( c0 - f.p1.y ) / ( f.p2.y - f.p1.y );
+    std::vector<Interval>::const_iterator it;
+    it = std::lower_bound( f.ints.begin(), f.ints.end(), t0-t_tol, upper_below );
+    for ( ; (it != f.ints.end()) && (it->lower <= t0+t_tol) ; ++it ) {
+        Point lower = f.point( it->lower );
+        Point upper = f.point( it->upper );
+        double cmin = xfiber ? lower.x : lower.y;
+        double cmax = xfiber ? upper.x : upper.y;
+        if ( (cmin <= c0) && (c1 <= cmax) )
+            return true;
+    }
+    return false;
+}
+
+// add the end-points of the x-interval, connected by a pair of edges
+void Weave::add_x_interval(unsigned int nx, unsigned int mx) {
+    Fiber& xf = xfibers[nx];
+    Interval& xi = xf.ints[mx];
+    IntervalProps& xp = xprops[nx][mx];
+    assert( !xp.in_weave ); // this is the first time the x-interval is added!
+    xp.in_weave = true;
+    // add the X interval end-points to the weave
+    Point p1( xf.point(xi.lower) );
+    IntervalEnd end1 = { 0, nx, mx, 0 };
+    Vertex xv1 = add_cl_vertex( p1, xp, p1.x, end1 ); 
+    Point p2( xf.point(xi.upper) );
+    IntervalEnd end2 = { 0, nx, mx, 1 };
+    Vertex xv2 = add_cl_vertex( p2, xp, p2.x, end2 );
+    Edge e1 = hedi::add_edge( xv1, xv2, g);
+    Edge e2 = hedi::add_edge( xv2, xv1, g);
+
+    //std::cout << " add_edge " << v1 << "("<< p1.x<< ") - " << v2 <<"("<< p2.x << ")\n";
+    hedi::set_next( e1, e2, g );
+    hedi::set_next( e2, e1, g );
+}
+
+// X interval xi on fiber xf intersects with Y interval yi on fiber yf
+// intersection is at ( yf.p1.x, xf.p1.y , xf.p1.z )
+void Weave::add_intersection(unsigned int nx, unsigned int mx, unsigned int ny, unsigned int my) {
+    Fiber& xf = xfibers[nx];
+    IntervalProps& xp = xprops[nx][mx];
+    Fiber& yf = yfibers[ny];
+    Interval& yi = yf.ints[my];
+    IntervalProps& yp = yprops[ny][my];
+    if (!yp.in_weave) { // add y-interval endpoints to weave
+        Point p1( yf.point(yi.lower) );
+        IntervalEnd end1 = { 1, ny, my, 0 };
+        add_cl_vertex( p1, yp, p1.y, end1 );
+        Point p2( yf.point(yi.upper) );
+        IntervalEnd end2 = { 1, ny, my, 1 };
+        add_cl_vertex( p2, yp, p2.y, end2 );
+        yp.in_weave = true;
+    }
+    // 3) intersection point, of type INT
+    Point v_position( yf.p1.x, xf.p1.y , xf.p1.z );
+    Vertex v = hedi::add_vertex( VertexProps( v_position, INT, boost::num_vertices( g ) ), g);
+    
+    // 4) add edges 
+    
+    // find x-neighbors
+    Vertex x_u, x_l;
+    boost::tie( x_u, x_l ) = find_neighbor_vertices( VertexPair(v, v_position.x) , xp); 
+    
+    // these original edges will eventually be deleted!
+    Edge xe_lu = hedi::edge( x_l, x_u, g);
+    Edge xe_ul = hedi::edge( x_u, x_l, g);
+    Edge xe_lu_next = g[xe_lu].next;
+    Edge xe_lu_prev = hedi::previous_edge( xe_lu, g );
+    Edge xe_ul_next = g[xe_ul].next;
+    Edge xe_ul_prev = hedi::previous_edge( xe_ul, g );
+    
+    // find y-neighbors
+    Vertex y_u, y_l;
+    boost::tie( y_u, y_l ) = find_neighbor_vertices( VertexPair(v, v_position.y) , yp); 
+    
+    // the next/prev data we need
+    Edge ye_lu, ye_ul;
+    Edge ye_lu_next, ye_lu_prev ;
+    Edge ye_ul_next, ye_ul_prev ;
+
+    bool y_lu_edge = hedi::has_edge( y_l, y_u, g ); // flag indicating existing y_l - y_u edge 
+    // the case where y_l and y_u are alread already connected.
+    if ( y_lu_edge ) {
+        //assert( hedi::has_edge( y_u, y_l, g ) ); // twin must also exist
+        ye_lu = hedi::edge( y_l, y_u, g);
+        ye_ul = hedi::edge( y_u, y_l, g);
+        ye_lu_next = g[ye_lu].next;
+        ye_lu_prev = hedi::previous_edge( ye_lu, g );
+        ye_ul_next = g[ye_ul].next;
+        ye_ul_prev = hedi::previous_edge( ye_ul, g );
+    } 
+    // and now eight new edges to add
+    Edge xl_v = hedi::add_edge(x_l, v  , g);
+    Edge v_yl = hedi::add_edge(v  , y_l, g);
+    Edge yl_v = hedi::add_edge(y_l, v  , g);
+    Edge v_xu = hedi::add_edge(v  , x_u, g);
+    Edge xu_v = hedi::add_edge(x_u, v  , g);
+    Edge v_yu = hedi::add_edge(v  , y_u, g);
+    Edge yu_v = hedi::add_edge(y_u, v  , g);
+    Edge v_xl = hedi::add_edge(v  , x_l, g);
+    // checks for special cases:
+    if (xe_lu_prev == xe_ul) // xl hairpin
+        xe_lu_prev = v_xl;
+    if (xe_lu_next == xe_ul) // xu hairpin
+        xe_lu_next = xu_v;
+    if (xe_ul_prev == xe_lu)
+        xe_ul_prev = v_xu;
+    if (xe_ul_next == xe_lu)
+        xe_ul_next = xl_v;
+    if ( y_lu_edge ) {
+        // the same checks for the y-edge
+        if (ye_lu_prev == ye_ul)
+            ye_lu_prev = v_yl;
+        if (ye_lu_next == ye_ul)
+            ye_lu_next = yu_v;
+        if (ye_ul_prev == ye_lu)
+            ye_ul_prev = v_yu;
+        if (ye_ul_next == ye_lu)
+            ye_ul_next = yl_v;
+    } else { // we should form a y-hairpin
+        ye_lu_next = yu_v;
+        ye_lu_prev = v_yl;
+        ye_ul_next = yl_v;
+        ye_ul_prev = v_yu;
+    }
+    // now set next/prev edges (there are 2*12=24 of these to do)
+    hedi::set_next( xe_lu_prev, xl_v, g );
+    hedi::set_next( xl_v, v_yl, g );
+    hedi::set_next( v_yl, ye_ul_next, g );
+    hedi::set_next( ye_lu_prev, yl_v, g );
+    hedi::set_next( yl_v, v_xu, g );
+    hedi::set_next( v_xu, xe_lu_next, g );
+    hedi::set_next( xe_ul_prev, xu_v, g );
+    hedi::set_next( xu_v, v_yu, g );
+    hedi::set_next( v_yu, ye_lu_next, g );
+    hedi::set_next( ye_ul_prev, yu_v, g );
+    hedi::set_next( yu_v, v_xl, g );
+    hedi::set_next( v_xl, xe_ul_next, g );
+    // delete the old edges
+    boost::remove_edge( x_l, x_u, g);
+    boost::remove_edge( x_u, x_l, g);
+    if ( y_lu_edge ) {
+        boost::remove_edge( y_l, y_u, g);
+        boost::remove_edge( y_u, y_l, g);
+    }
+    
+    // finally add new intersection vertex to the interval sets
+    xp.intersections.insert( VertexPair( v, v_position.x ) );
+    yp.intersections.insert( VertexPair( v, v_position.y ) );
+}
+
 std::vector< std::vector<Point> > Weave::getLoops() const {
     std::vector< std::vector<Point> > loop_list;
     BOOST_FOREACH( std::vector<Vertex> loop, loops ) {
@@ -261,6 +397,24 @@ std::vector< std::vector<Point> > Weave::getLoops() const {
     return loop_list;
 }
 
+std::vector< std::vector<IntervalEnd> > Weave::getLoopEnds() const {
+    std::vector< std::vector<IntervalEnd> > loop_list;
+    BOOST_FOREACH( const std::vector<Vertex>& loop, loops ) {
+        std::vector<IntervalEnd> end_list;
+        BOOST_FOREACH( Vertex v, loop ) {
+            end_list.push_back( cl_end(v) );
+        }
+        loop_list.push_back(end_list);
+    }
+    return loop_list;
+}
+
+std::vector<IntervalEnd> Weave::getCLEnds() const {
+    std::vector<IntervalEnd> end_list;
+    for (unsigned int n=0; n<clEnds.size(); ++n)
+        end_list.push_back( clEnds[n].second );
+    return end_list;
+}
 
 // this can cause a build error when both face and vertex descriptors have the same type
 // i.e. unsigned int (?)
@@ -272,7 +426,7 @@ void Weave::printGraph() const {
     boost::tie( it_begin, it_end ) = boost::vertices( g );
     int n=0, n_cl=0, n_internal=0;
     for ( itr=it_begin ; itr != it_end ; ++itr ) {
-        if ( g[*itr].type == CL )
+        if ( (g[*itr].type == CL) || (g[*itr].type == CL_DONE) )
             ++n_cl;
         else
             ++n_internal;
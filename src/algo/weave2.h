@@ -25,6 +25,7 @@
 #include "point.h"
 #include "fiber.h"
 #include "weave2_typedef.h"
+#include "weave2_common.h"
 #include "halfedgediagram.hpp"
 
 namespace ocl
@@ -36,26 +37,20 @@ namespace weave2
 /// vertex properties
 struct VertexProps {
     VertexProps() {
-        init();
+        index = -1;
     }
-    /// construct vertex at position p with type t
-    VertexProps( Point p, VertexType t) {
+    /// construct vertex at position p with type t and index i
+    VertexProps( Point p, VertexType t, int i) {
         position=p;
         type=t;
-        init();
-    }
-    void init() {
-        index = count;
-        count++;
+        index=i;
     }
     VertexType type;
 // HE data
     /// the position of the vertex
     Point position;
-    /// index of vertex
+    /// index of vertex, in the order vertices were added to the Weave
     int index;
-    /// global vertex count
-    static int count;
 };
 
 /// edge properties
@@ -63,7 +58,7 @@ struct EdgeProps {
     EdgeProps() {}
     /// the next edge, counterclockwise, from this edge
     Edge next;
-    /// previous edge, to make Weave::build() faster, since we avoid calling hedi::previous_edge() 
+    /// the previous edge, set with next by hedi::set_next()
     Edge prev;
     /// the twin edge
     Edge twin;
@@ -71,6 +66,18 @@ struct EdgeProps {
 };
 
 
+/// the weave-bookkeeping of one Interval of a Fiber
+struct IntervalProps {
+    IntervalProps() {
+        in_weave = false;
+    }
+    /// flag for use by Weave::build()
+    bool in_weave; 
+    /// intersections with other intervals are stored in this set of
+    /// VertexPairs of type std::pair<VertexDescriptor, double>
+    VertexIntersectionSet intersections;
+};
+
 /// properties of a face in the weave
 struct FaceProps {
     /// create face with given edge, generator, and type
@@ -97,7 +104,7 @@ class Weave {
         void addFiber(Fiber& f);
         
         /// from the list of fibers, build a graph
-        void build();
+        void build() {this->build3();}
 
         /// run planar_face_traversal to get the waterline loops
         void face_traverse();
@@ -105,6 +112,11 @@ class Weave {
         /// retrun list of loops
         std::vector< std::vector<Point> > getLoops() const;
         
+        /// the loops, as the interval ends of their CL-vertices
+        std::vector< std::vector<IntervalEnd> > getLoopEnds() const;
+        /// the interval ends of all CL-vertices, in the order build() added them
+        std::vector<IntervalEnd> getCLEnds() const;
+        
         /// string representation
         std::string str() const;
         
@@ -112,14 +124,39 @@ class Weave {
         void printGraph() const;
         
     protected:       
+        /// build the graph, testing every y-fiber against every x-interval
+        void build1();
+        /// build the graph, finding the y-fibers and y-intervals that cross an 
+        /// x-interval by binary search
+        void build2();
+        /// as build2(), but intersections inside the area covered by intervals are left out.
+        /// the graph then grows with the length of the loops, not the area inside them.
+        void build3();
+        /// build2() and build3(), with compact true for build3()
+        void build_sorted(bool compact);
+        /// true if the intersection of x-fiber xsorted[a].second and y-fiber ysorted[b].second 
+        /// is surrounded by cells covered by intervals, so it can't be on a loop.
+        /// xsorted and ysorted are the fibers sorted by coordinate.
+        bool inside(const std::vector< std::pair<double, unsigned int> >& xsorted, unsigned int a,
+                    const std::vector< std::pair<double, unsigned int> >& ysorted, unsigned int b) const;
+        /// true if one interval of Fiber f covers the coordinates c0 <= c1, along x for an X-fiber, along y for a Y-fiber
+        bool covers(const Fiber& f, bool xfiber, double c0, double c1) const;
+        /// add the end-points of interval mx of x-fiber nx to the graph
+        void add_x_interval(unsigned int nx, unsigned int mx);
+        /// add the intersection of interval mx of x-fiber nx with interval my of y-fiber ny to the graph.
+        /// the end-points of the y-interval are added if they are not in the graph yet.
+        void add_intersection(unsigned int nx, unsigned int mx, unsigned int ny, unsigned int my);
     
         /// add CL vertex to weave
-        /// sets position, type, and inserts the VertexPair into Interval::intersections
-        /// also adds the CL-vertex to clVertices, a list of cl-verts to be processed during face_traverse()
-        Vertex add_cl_vertex( Point& position, Interval& interv, double ipos);
+        /// sets position, type, and inserts the VertexPair into IntervalProps::intersections
+        /// also adds the CL-vertex to clVertices, a list of cl-verts to be processed during face_traverse(),
+        /// and its interval end to clEnds
+        Vertex add_cl_vertex( Point& position, IntervalProps& interv, double ipos, const IntervalEnd& e);
+        /// the interval end of CL-vertex v
+        IntervalEnd cl_end(Vertex v) const;
         
         /// given a vertex in the graph, find it's upper and lower neighbor vertices
-        std::pair<Vertex,Vertex> find_neighbor_vertices( VertexPair v_pair, Interval& ival);
+        std::pair<Vertex,Vertex> find_neighbor_vertices( VertexPair v_pair, IntervalProps& ival);
          
 // DATA
         /// the weave-graph
@@ -130,8 +167,14 @@ class Weave {
         std::vector<Fiber> xfibers;
         /// the Y-fibers
         std::vector<Fiber> yfibers;
-        /// set of CL-points
-        std::set<Vertex> clVertices;
+        /// weave-bookkeeping for the intervals of each X-fiber
+        std::vector< std::vector<IntervalProps> > xprops;
+        /// weave-bookkeeping for the intervals of each Y-fiber
+        std::vector< std::vector<IntervalProps> > yprops;
+        /// the CL-points, in the order they were added
+        std::vector<Vertex> clVertices;
+        /// the interval end of each CL-point, as pairs (vertex index, interval end), in the order they were added
+        std::vector< std::pair<int, IntervalEnd> > clEnds;
 };
 
 } // end weave2 namespace
@@ -0,0 +1,79 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef WEAVE2_COMMON_H
+#define WEAVE2_COMMON_H
+
+#include "interval.h"
+
+namespace ocl
+{
+
+namespace weave2
+{
+
+/// a CL-point, the lower or upper end of an interval of a fiber.
+/// used by Weave, ContourTracer, and TiledWeave
+struct IntervalEnd {
+    /// 0 for an X-fiber, 1 for a Y-fiber
+    int axis;
+    /// the fiber index, in the order the fibers were added
+    unsigned int fiber;
+    /// the interval index
+    unsigned int interval;
+    /// 0 for the lower end, 1 for the upper end
+    int end;
+};
+
+/// the order of a CL-point in Weave::build():
+/// the X-intervals are added in fiber order, each followed by the Y-intervals that
+/// first cross it, in x-order.
+struct CLOrder {
+    unsigned int nx; ///< the X-fiber
+    unsigned int mx; ///< the X-interval
+    int stage; ///< 0 for the X-interval, 1 for the Y-intervals crossing it
+    unsigned int b; ///< the x-order of the Y-fiber
+    unsigned int my; ///< the Y-interval
+    int end; ///< lower or upper end
+    bool operator<(const CLOrder& o) const {
+        if ( nx != o.nx ) return nx < o.nx;
+        if ( mx != o.mx ) return mx < o.mx;
+        if ( stage != o.stage ) return stage < o.stage;
+        if ( b != o.b ) return b < o.b;
+        if ( my != o.my ) return my < o.my;
+        return end < o.end;
+    }
+};
+
+/// compare pairs by the first member only
+template <class Pair>
+inline bool first_less(const Pair& a, const Pair& b) {
+    return a.first < b.first;
+}
+
+/// compare the upper end of an interval with a t-value, for std::lower_bound
+inline bool upper_below(const Interval& i, double t) {
+    return i.upper < t;
+}
+
+} // end weave2 namespace
+
+} // end ocl namespace
+#endif
+// end file weave2_common.h
@@ -34,14 +34,14 @@ struct FaceProps;
 typedef unsigned int Face;  
   
 // the graph type for the weave
-typedef HEDIGraph<     boost::listS,             // out-edges stored here
-                       boost::listS,             // vertex set stored here
+typedef HEDIGraph<     arenaS,                   // out-edges stored here
+                       arenaS,                   // vertex set stored here
                        boost::bidirectionalS,    // undirecgted or bidirectional graph?
                        VertexProps,              // vertex properties
                        EdgeProps,                // edge properties
                        FaceProps,                // face properties
                        boost::no_property,       // graph properties
-                       boost::listS             // edge storage
+                       arenaS                   // edge storage
                        > WeaveGraph;
 
 typedef boost::graph_traits< WeaveGraph >::vertex_descriptor  Vertex;
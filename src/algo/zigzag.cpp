@@ -0,0 +1,303 @@
+/*  $Id$
+ * 
+ *  Copyright 2010 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#ifdef _OPENMP  
+    #include <omp.h>
+#endif
+
+#include "zigzag.h"
+
+namespace ocl
+{
+
+// the number of bands of scanlines for each thread
+static const unsigned int BANDS_PER_THREAD = 8;
+
+ZigZag::ZigZag() {
+    stepOver = 0.0;
+    kfirst = 0;
+    dmax = 0.0;
+    topLine = false;
+    nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_num_procs();
+#endif
+}
+
+void ZigZag::addPoint(const Point& p) {
+    if ( pocket.empty() )
+        pocket.push_back( std::vector<Point>() );
+    pocket.back().push_back(p);
+    bb.addPoint(p);
+}
+
+void ZigZag::addPolygon(const std::vector<Point>& polygon) {
+    pocket.push_back( polygon );
+    BOOST_FOREACH( const Point& p, polygon ) {
+        bb.addPoint(p);
+    }
+}
+
+std::string ZigZag::str() const {
+    std::ostringstream o;
+    unsigned int n = 0;
+    BOOST_FOREACH( const std::vector<Point>& polygon, pocket ) {
+        n += polygon.size();
+    }
+    o << "ZigZag: " << pocket.size() << " polygons with " << n << " points, " << paths.size() << " paths" << std::endl;
+    return o.str();
+}
+
+void ZigZag::project(const Point& p, double& d, double& t) const {
+    Point r = p - origin;
+    d = r.x*v.x + r.y*v.y;
+    t = r.x*u.x + r.y*u.y;
+}
+
+Point ZigZag::position(int k, double t) const {
+    double d = (k+kfirst)*stepOver;
+    return Point( origin.x + d*v.x + t*u.x, origin.y + d*v.y + t*u.y, origin.z );
+}
+
+// An edge crosses scanline k when one end is below the line and the other is not. A vertex at
+// distance d is below line k when k >= ceil(d/stepOver), for both of its edges, so each closed
+// polygon crosses each line an even number of times. This keeps a scanline on the bottom edge
+// of the pocket. A scanline on the top edge would cross nothing, so there a vertex on the line
+// is above it instead, and the scanlines from dmin to dmax are kept, both ends included.
+bool ZigZag::crossed(unsigned int e, int& k0, int& k1) const {
+    double lo = std::min( vd[e], vd[ succ[e] ] );
+    double hi = std::max( vd[e], vd[ succ[e] ] );
+    k0 = (int) ceil( lo/stepOver ) - kfirst;
+    k1 = (int) ceil( hi/stepOver ) - kfirst - 1;
+    if ( topLine && hi == dmax && lo < hi ) // the edge reaches the scanline on the top edge
+        k1++;
+    return ( k0 <= k1 ); // false if the edge is between two scanlines, or along one
+}
+
+void ZigZag::run() {
+    paths.clear();
+    segments.clear();
+    u = Point( dir.x, dir.y, 0 );
+    u.xyNormalize();
+    v = u.xyPerp();
+    if ( stepOver <= 0.0 || u.xyNorm() == 0.0 ) {
+        std::cout << " ERROR: ZigZag::run() needs a step-over and a direction\n";
+        return;
+    }
+    vd.clear();
+    vt.clear();
+    succ.clear();
+    BOOST_FOREACH( const std::vector<Point>& polygon, pocket ) {
+        unsigned int start = vd.size();
+        BOOST_FOREACH( const Point& p, polygon ) {
+            double d, t;
+            project( p, d, t );
+            vd.push_back(d);
+            vt.push_back(t);
+            succ.push_back( vd.size() );
+        }
+        if ( !polygon.empty() )
+            succ.back() = start;
+    }
+    if ( vd.empty() )
+        return;
+    double dmin = *std::min_element( vd.begin(), vd.end() );
+    dmax = *std::max_element( vd.begin(), vd.end() );
+    kfirst = (int) ceil( dmin/stepOver );
+    topLine = ( ceil( dmax/stepOver ) == floor( dmax/stepOver ) );
+    int nlines = (int) floor( dmax/stepOver ) - kfirst + 1;
+    if ( nlines <= 0 )
+        return;
+    segments.resize( nlines );
+    
+    // sort the edges into the bands of scanlines they cross
+    unsigned int nbands = std::min( (unsigned int)nlines, std::max( 1u, BANDS_PER_THREAD*nthreads ) );
+    unsigned int bandSize = ( nlines + nbands - 1 ) / nbands;
+    nbands = ( nlines + bandSize - 1 ) / bandSize;
+    std::vector< std::vector<unsigned int> > bands( nbands );
+    for (unsigned int e=0; e<vd.size(); ++e) {
+        int k0, k1;
+        if ( !crossed( e, k0, k1 ) )
+            continue;
+        for (unsigned int b=k0/bandSize; b<=k1/bandSize; ++b)
+            bands[b].push_back(e);
+    }
+    
+    // the edges in each gap between two scanlines, for the moves between them. an edge
+    // between two scanlines crosses none, but it can still block a move
+    gaps.assign( nlines-1, std::vector<unsigned int>() );
+    for (unsigned int e=0; e<vd.size(); ++e) {
+        double lo = std::min( vd[e], vd[ succ[e] ] );
+        double hi = std::max( vd[e], vd[ succ[e] ] );
+        int g0 = std::max( (int) floor( lo/stepOver ) - kfirst, 0 );
+        int g1 = std::min( (int) ceil( hi/stepOver ) - kfirst - 1, nlines-2 );
+        for (int g=g0; g<=g1; ++g)
+            gaps[g].push_back(e);
+    }
+    
+    int b;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) private(b)
+    for (b=0; b< (int)nbands; ++b)
+        clip( bands[b], b*bandSize, std::min( (b+1)*bandSize, (unsigned int)nlines ) );
+    int k;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic, 64) private(k)
+    for (k=0; k<nlines-1; ++k)
+        link(k);
+    
+    // follow the links from each segment that no segment links to
+    for (k=0; k<nlines; ++k) {
+        for (unsigned int s=0; s<segments[k].size(); ++s) {
+            if ( segments[k][s].linked )
+                continue;
+            std::vector<Point> path;
+            int kk = k;
+            int ss = s;
+            for (;;) {
+                const Segment& seg = segments[kk][ss];
+                if ( (kk+kfirst) % 2 == 0 ) { // zig
+                    path.push_back( position( kk, seg.t1 ) );
+                    path.push_back( position( kk, seg.t2 ) );
+                } else { // zag
+                    path.push_back( position( kk, seg.t2 ) );
+                    path.push_back( position( kk, seg.t1 ) );
+                }
+                if ( seg.next < 0 )
+                    break;
+                ss = seg.next;
+                kk++;
+            }
+            paths.push_back( path );
+        }
+    }
+}
+
+void ZigZag::clip(const std::vector<unsigned int>& edges, unsigned int first, unsigned int last) {
+    std::vector< std::vector<double> > crossings( last-first );
+    BOOST_FOREACH( unsigned int e, edges ) {
+        unsigned int f = succ[e];
+        int k0, k1;
+        crossed( e, k0, k1 );
+        k0 = std::max( k0, (int)first );
+        k1 = std::min( k1, (int)last-1 );
+        for (int k=k0; k<=k1; ++k) {
+            double d = (k+kfirst)*stepOver;
+            if ( d == vd[f] ) // exactly at the end vertex
+                crossings[k-first].push_back( vt[f] );
+            else
+                crossings[k-first].push_back( vt[e] + (vt[f]-vt[e])*(d-vd[e])/(vd[f]-vd[e]) );
+        }
+    }
+    for (unsigned int k=first; k<last; ++k) {
+        std::vector<double>& c = crossings[k-first];
+        std::sort( c.begin(), c.end() );
+        for (unsigned int m=0; m+1<c.size(); m+=2) { // inside from each odd crossing to the next one
+            if ( c[m+1] > c[m] ) {
+                Segment s;
+                s.t1 = c[m];
+                s.t2 = c[m+1];
+                s.next = -1;
+                s.linked = false;
+                segments[k].push_back(s);
+            }
+        }
+    }
+}
+
+// the segments of each scanline are sorted and disjoint, so the overlapping pairs are found by a merge
+void ZigZag::link(unsigned int k) {
+    std::vector<Segment>& s1 = segments[k];
+    std::vector<Segment>& s2 = segments[k+1];
+    std::vector<unsigned int> n1( s1.size(), 0 );
+    std::vector<unsigned int> n2( s2.size(), 0 );
+    std::vector< std::pair<unsigned int, unsigned int> > pairs;
+    unsigned int i = 0, j = 0;
+    while ( i < s1.size() && j < s2.size() ) {
+        if ( s1[i].t1 <= s2[j].t2 && s2[j].t1 <= s1[i].t2 ) {
+            n1[i]++;
+            n2[j]++;
+            pairs.push_back( std::make_pair(i, j) );
+        }
+        if ( s1[i].t2 < s2[j].t2 )
+            ++i;
+        else
+            ++j;
+    }
+    // a zig ends at t2 and the zag after it starts at t2, a zag ends and the next zig starts at t1
+    bool zig = ( ((int)k+kfirst) % 2 == 0 );
+    for (unsigned int m=0; m<pairs.size(); ++m) {
+        Segment& a = s1[ pairs[m].first ];
+        Segment& b = s2[ pairs[m].second ];
+        if ( n1[ pairs[m].first ] == 1 && n2[ pairs[m].second ] == 1 &&
+             inside( k, zig ? a.t2 : a.t1, zig ? b.t2 : b.t1 ) ) {
+            a.next = pairs[m].second;
+            b.linked = true;
+        }
+    }
+}
+
+// The move starts and ends on the boundary of the pocket. It is inside when no edge crosses it
+// between the ends, and its midpoint is inside. Only the edges of gap k can do either.
+bool ZigZag::inside(unsigned int k, double ta, double tb) const {
+    double da = ((int)k+kfirst)*stepOver;
+    double db = da + stepOver;
+    double eps = 1e-12*( stepOver + (bb.maxpt-bb.minpt).xyNorm() );
+    double lm = sqrt( (db-da)*(db-da) + (tb-ta)*(tb-ta) );
+    BOOST_FOREACH( unsigned int e, gaps[k] ) {
+        unsigned int f = succ[e];
+        double le = sqrt( (vd[f]-vd[e])*(vd[f]-vd[e]) + (vt[f]-vt[e])*(vt[f]-vt[e]) );
+        if ( le == 0.0 )
+            continue;
+        // the distances of the edge ends from the move, and of the move ends from the edge.
+        // a move along an edge, or from an edge it starts or ends on, does not cross it
+        double de = ( (db-da)*(vt[e]-ta) - (tb-ta)*(vd[e]-da) ) / lm;
+        double df = ( (db-da)*(vt[f]-ta) - (tb-ta)*(vd[f]-da) ) / lm;
+        double pa = ( (vd[f]-vd[e])*(ta-vt[e]) - (vt[f]-vt[e])*(da-vd[e]) ) / le;
+        double pb = ( (vd[f]-vd[e])*(tb-vt[e]) - (vt[f]-vt[e])*(db-vd[e]) ) / le;
+        if ( ( de > eps && df > eps ) || ( de < -eps && df < -eps ) )
+            continue;
+        if ( ( pa < -eps && pb > eps ) || ( pa > eps && pb < -eps ) )
+            return false;
+    }
+    // the crossings of the edges with the line through the midpoint, before it
+    double dm = 0.5*(da+db);
+    double tm = 0.5*(ta+tb);
+    bool in = false;
+    BOOST_FOREACH( unsigned int e, gaps[k] ) {
+        unsigned int f = succ[e];
+        if ( (vd[e] > dm) == (vd[f] > dm) )
+            continue;
+        double t = vt[e] + (vt[f]-vt[e])*(dm-vd[e])/(vd[f]-vd[e]);
+        if ( fabs(t - tm) <= eps ) // the move runs along the edge
+            return true;
+        if ( t < tm )
+            in = !in;
+    }
+    return in;
+}
+
+} // end namespace
+// end file zigzag.cpp
@@ -24,88 +24,113 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <cassert>
 
 #include "point.h"
+#include "bbox.h"
 
 namespace ocl
 {
 
-/// zgizag 2D operation
+/// \brief zigzag 2D operation
+///
+/// The pocket is given as polygons in the xy-plane, the boundary and its islands. A point is in the
+/// pocket when it is inside an odd number of polygons. ZigZag intersects the pocket with parallel
+/// scanlines along the direction, spaced by the step-over and aligned with the origin.
+/// The scanlines span the pocket inclusively: a scanline on the bottom or the top edge of the
+/// pocket, at the least or the greatest distance along the normal, is kept.
+/// The edges are sorted into bands of scanlines, and the bands are clipped on separate threads.
+/// The crossings of each scanline are sorted, and pair up into the segments inside the pocket.
+/// A segment is linked to a segment on the next scanline when each is the only one overlapping
+/// the other, and the move between them stays inside the pocket, so that a zigzag path runs
+/// back and forth until the pocket branches or a wall is in the way.
 class ZigZag {
     public:
-        ZigZag() { }
+        ZigZag();
         virtual ~ZigZag() {}
         /// step over distance 
         void setStepOver(double d) {
             stepOver = d;
         }
-        /// set dir
+        /// set the direction of the scanlines
         void setDirection(Point d) {
             dir = d;
         }
+        /// set a point on one of the scanlines. the z-coordinate of the paths is origin.z
         void setOrigin(Point d) {
             origin = d;
         }
-        
-        /// run the algorithm
-        void run() {
-            // calculate a reasonable maximum/minimum step-over dist
-            Point perp = dir.xyPerp();
-            perp.xyNormalize();
-            std::cout << " minpt = " << bb.minpt << std::endl;
-            std::cout << " maxpt = " << bb.maxpt << std::endl;
-            std::cout << " perp = " << perp << std::endl;
-            double max_d = (bb.maxpt - origin).dot( perp );
-            double min_d = (bb.minpt - origin).dot( perp );
-            if ( max_d < min_d ) {
-                double tmp = max_d;
-                max_d = min_d;
-                min_d = tmp;
-            }
-            //int n = min_d / stepOver; // some safety margin here... (required?)
-            std::cout << " max_d= " << max_d << " min_d= "<< min_d << std::endl;
-            
-            std::vector<double> distances;
-            for (double d = min_d ; d <= max_d ; d += stepOver ) {
-                distances.push_back(d);
-                out.push_back( origin + d*perp );
-                assert( out.size() < 500 );
-            }
-            
-        }
-        
-        boost::python::list getOutput() const {
-            boost::python::list o;
-            BOOST_FOREACH( Point p, out ) {
-                o.append(p);
-            }
-            return o;
+        /// set the number of threads
+        void setThreads(unsigned int n) {
+            nthreads = n;
         }
-        
-        /// add an input CLPoint to this Operation
-        void addPoint(Point& p) {
-            pocket.push_back(p);
-            bb.addPoint(p);
-        }
-        std::string str() const {
-            std::ostringstream o;
-            o << "ZigZag: pocket.size()=" << pocket.size() << std::endl;
-            return o.str();
+        /// add a point to the last polygon of the pocket
+        void addPoint(const Point& p);
+        /// add a polygon to the pocket. the last point connects to the first
+        void addPolygon(const std::vector<Point>& polygon);
+        /// run the algorithm
+        void run();
+        /// the zigzag paths
+        std::vector< std::vector<Point> > getPaths() const {
+            return paths;
         }
+        /// string repr
+        std::string str() const;
     protected:
+        /// a segment of a scanline, from t1 to t2 along the direction
+        struct Segment {
+            double t1, t2;
+            /// the segment on the next scanline it links to, or -1
+            int next;
+            /// true if a segment on the previous scanline links to this one
+            bool linked;
+        };
+        /// the distance of p along the normal of the scanlines, and along the direction
+        void project(const Point& p, double& d, double& t) const;
+        /// the scanlines k0 to k1 crossed by edge e, from vertex e to succ[e]. false if none
+        bool crossed(unsigned int e, int& k0, int& k1) const;
+        /// intersect the scanlines first to last-1 with the edges
+        void clip(const std::vector<unsigned int>& edges, unsigned int first, unsigned int last);
+        /// link the segments of scanline k to those of scanline k+1
+        void link(unsigned int k);
+        /// true if the move from ta on scanline k to tb on scanline k+1 is inside the pocket
+        bool inside(unsigned int k, double ta, double tb) const;
+        /// the point at position t along scanline k
+        Point position(int k, double t) const;
+        
+    // DATA
         /// the step over
         double stepOver;
         /// direction 
         Point dir;
         /// origin
         Point origin;
-        /// pocket
-        std::vector<Point> pocket;
-        std::vector<Point> out;
+        /// the number of threads
+        unsigned int nthreads;
+        /// the polygons of the pocket
+        std::vector< std::vector<Point> > pocket;
+        /// the bounding box of the pocket
         Bbox bb;
+        /// the unit direction and unit normal of the scanlines
+        Point u, v;
+        /// the number of the first scanline
+        int kfirst;
+        /// the greatest distance of a pocket vertex along the normal
+        double dmax;
+        /// true if the last scanline is at dmax, on the top edge of the pocket
+        bool topLine;
+        /// the segments of each scanline
+        std::vector< std::vector<Segment> > segments;
+        /// the edges of each gap, between scanline k and k+1
+        std::vector< std::vector<unsigned int> > gaps;
+        /// the projections of the pocket vertices, d along the normal and t along the direction
+        std::vector<double> vd, vt;
+        /// the next vertex of each vertex in its polygon
+        std::vector<unsigned int> succ;
+        /// the zigzag paths
+        std::vector< std::vector<Point> > paths;
 };
 
 } // end namespace
 
-#endif // end zigzag.h
+#endif
+// end file zigzag.h
@@ -0,0 +1,65 @@
+/*  $Id$
+ * 
+ *  Copyright 2010 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *  
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ZIGZAG_PY_H
+#define ZIGZAG_PY_H
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "zigzag.h"
+#include "array_py.h"
+
+namespace ocl
+{
+
+/// Python wrapper for ZigZag
+class ZigZag_py : public ZigZag {
+    public:
+        ZigZag_py() : ZigZag() {}
+        /// add a list of Points as a polygon of the pocket
+        void addPolygon_py(const boost::python::list& point_list) {
+            std::vector<Point> polygon;
+            for (int n=0; n<boost::python::len(point_list); ++n)
+                polygon.push_back( boost::python::extract<Point>( point_list[n] ) );
+            addPolygon( polygon );
+        }
+        /// return the zigzag paths as a list of lists to python
+        boost::python::list getOutput() const {
+            boost::python::list path_list;
+            BOOST_FOREACH( const std::vector<Point>& path, paths ) {
+                boost::python::list point_list;
+                BOOST_FOREACH( Point p, path ) {
+                    point_list.append( p );
+                }
+                path_list.append(point_list);
+            }
+            return path_list;
+        }
+        /// return the zigzag paths to python as Arrays, see loop_arrays()
+        boost::python::tuple getOutputArrays() const {
+            return loop_arrays( paths );
+        }
+};
+
+} // end namespace
+#endif
+// end file zigzag_py.h
@@ -0,0 +1,71 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include "millingcutter.h"
+#include "stlsurf.h"
+#include "zslice.h"
+
+namespace ocl
+{
+
+ZSlice::ZSlice() {
+    z = 0.0;
+    tree = NULL;
+}
+
+ZSlice::~ZSlice() {
+    delete tree;
+}
+
+// a triangle is in the band if its bounding-box overlaps the bounding-box of
+// the cutter at z-height zh, i.e. the test done by the kd-tree search of BatchPushCutter
+void ZSlice::build(const STLSurf& s, const MillingCutter* c, double zh,
+                   unsigned int nthreads, unsigned int bucketSize) {
+    z = zh;
+    tris.clear();
+    delete tree;
+    tree = NULL;
+    std::vector<const Triangle*> band;
+    BOOST_FOREACH( const Triangle& t, s.tris ) {
+        if ( !( t.bb.maxpt.z < zh ) && !( t.bb.minpt.z > zh + c->getLength() ) )
+            band.push_back( &t );
+    }
+    int N = band.size();
+    std::vector<SlicedTriangle> sliced( N );
+    int n; // loop variable
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared(band, sliced) private(n)
+    for (n=0; n<N; ++n) {
+        sliced[n] = SlicedTriangle( *band[n], zh );
+    } // OpenMP parallel region ends here
+    tris.assign( sliced.begin(), sliced.end() );
+    if ( tris.empty() )
+        return;
+    tree = new KDTree<SlicedTriangle>();
+    tree->setBucketSize( bucketSize );
+    tree->setXYDimensions(); // the z-band is already filtered
+    tree->build( tris );
+}
+
+} // end namespace
+// end file zslice.cpp
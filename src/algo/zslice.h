@@ -0,0 +1,69 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ZSLICE_H
+#define ZSLICE_H
+
+#include <list>
+
+#include "point.h"
+#include "triangle.h"
+#include "slicedtriangle.h"
+#include "kdtree.h"
+
+namespace ocl
+{
+
+class STLSurf;
+class MillingCutter;
+
+/// \brief the triangles that a push-cutter can touch at one z-height
+///
+/// ZSlice holds a SlicedTriangle for each triangle of an STLSurf that overlaps
+/// the z-band [zh, zh+cutter.getLength()], and a kd-tree over these triangles.
+/// The kd-tree searches in the XY-plane, so one ZSlice is shared by the
+/// X- and Y-fibers of a Waterline.
+class ZSlice {
+    public:
+        ZSlice();
+        virtual ~ZSlice();
+        /// compute the SlicedTriangles of s for cutter c at z-height zh,
+        /// using nthreads OpenMP threads, and build the kd-tree
+        void build(const STLSurf& s, const MillingCutter* c, double zh,
+                   unsigned int nthreads, unsigned int bucketSize);
+        /// return the z-height
+        double getZ() const {return z;}
+        /// return the number of triangles in the slice
+        unsigned int size() const {return tris.size();}
+        /// the kd-tree, or NULL if the slice is empty
+        KDTree<SlicedTriangle>* getTree() const {return tree;}
+    protected:
+        /// the z-height
+        double z;
+        /// the triangles in the z-band
+        std::list<SlicedTriangle> tris;
+        /// kd-tree over tris
+        KDTree<SlicedTriangle>* tree;
+};
+
+} // end namespace
+
+#endif
+// end file zslice.h
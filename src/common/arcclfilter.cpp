@@ -0,0 +1,400 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include "arcclfilter.h"
+
+namespace ocl
+{
+
+// the share of the tolerance for the coordinate normal to the plane of an arc. the end of the
+// arc is off the plane by as much again, which leaves sqrt(1-0.5^2) of the tolerance in the plane
+static const double NORMAL_TOL = 0.25;
+static const double PLANE_TOL = 0.8660254;
+
+// the coordinates of p in plane. (u,v) are counterclockwise seen from the positive w-axis
+static void to_plane(const Point& p, ArcPlane plane, double& u, double& v, double& w) {
+    switch (plane) {
+        case XY_PLANE: u = p.x; v = p.y; w = p.z; break;
+        case XZ_PLANE: u = p.z; v = p.x; w = p.y; break;
+        default:       u = p.y; v = p.z; w = p.x; break;
+    }
+}
+
+// the point with coordinates (u,v,w) in plane
+static Point from_plane(double u, double v, double w, ArcPlane plane) {
+    switch (plane) {
+        case XY_PLANE: return Point(u, v, w);
+        case XZ_PLANE: return Point(v, w, u);
+        default:       return Point(w, u, v);
+    }
+}
+
+ArcCLFilter::ArcCLFilter() {
+    tol = 0.01;
+    arcs = true;
+    maxRadius = 1000;
+    nthreads = 1;
+    started = false;
+    hasTangent = false;
+    tested = 0;
+    for (int n=0; n<6; ++n)
+        fits[n].plane = (ArcPlane) (n/2);
+}
+
+void ArcCLFilter::addCLPoints(const CLPoint* p, unsigned int n) {
+    for (unsigned int m=0; m<n; ++m)
+        add( p[m] );
+}
+
+void ArcCLFilter::addCLPoints(const std::vector<CLPoint>& chunk) {
+    if ( !chunk.empty() )
+        addCLPoints( &chunk[0], chunk.size() );
+}
+
+void ArcCLFilter::add(const Point& p) {
+    if ( !started ) {
+        CLMove m;
+        m.end = p;
+        moves.push_back( m );
+        anchor = p;
+        hasTangent = false;
+        started = true;
+        reset();
+        return;
+    }
+    pending.push_back( p );
+    process();
+}
+
+void ArcCLFilter::endPath() {
+    while ( !pending.empty() ) {
+        process();
+        if ( !pending.empty() )
+            emit();
+    }
+    started = false;
+}
+
+void ArcCLFilter::takeMoves(std::vector<CLMove>& out) {
+    out.insert( out.end(), moves.begin(), moves.end() );
+    moves.clear();
+}
+
+std::vector< std::vector<CLMove> > ArcCLFilter::filterPaths(const std::vector< std::vector<CLPoint> >& paths,
+                                                            bool closed) const {
+    std::vector< std::vector<CLMove> > out( paths.size() );
+    int n;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) private(n)
+    for (n=0; n< (int)paths.size(); ++n) {
+        ArcCLFilter f;
+        f.setTolerance( tol );
+        f.setArcs( arcs );
+        f.setMaxRadius( maxRadius );
+        f.addCLPoints( paths[n] );
+        if ( closed && !paths[n].empty() )
+            f.addCLPoints( &paths[n][0], 1 );
+        f.endPath();
+        f.takeMoves( out[n] );
+    }
+    return out;
+}
+
+void ArcCLFilter::process() {
+    while ( tested < pending.size() ) {
+        int k = tested;
+        const Point& q = pending[k];
+        if ( line.alive )
+            line.test( anchor, q, k, tol );
+        for (int n=0; n<6; ++n) {
+            ArcFit& a = fits[n];
+            if ( !a.alive )
+                continue;
+            if ( a.tu == 0.0 && a.tv == 0.0 ) { // an estimated tangent needs two points
+                if ( k == 0 )
+                    continue;
+                start_estimated_arc( a );
+                if ( !a.alive )
+                    continue;
+            }
+            a.test( anchor, q, k, tol, maxRadius );
+        }
+        ++tested;
+        if ( !alive() )
+            emit();
+    }
+}
+
+bool ArcCLFilter::alive() const {
+    if ( line.alive )
+        return true;
+    for (int n=0; n<6; ++n) {
+        if ( fits[n].alive )
+            return true;
+    }
+    return false;
+}
+
+void ArcCLFilter::reset() {
+    line.reset();
+    for (int n=0; n<6; n+=2) {
+        ArcFit& a = fits[n];
+        a.alive = false;
+        a.last = -1;
+        if ( arcs && hasTangent ) {
+            double tu, tv, tw;
+            to_plane( tangent, a.plane, tu, tv, tw );
+            double len = sqrt( tu*tu + tv*tv );
+            if ( len > 0.999 ) { // the tangent must be in the plane
+                a.reset( tu/len, tv/len );
+                a.prev = anchor;
+            }
+        }
+        fits[n+1].reset( 0.0, 0.0 );
+        fits[n+1].alive = arcs;
+        fits[n+1].prev = anchor;
+    }
+}
+
+void ArcCLFilter::start_estimated_arc(ArcFit& a) {
+    // the circle through the anchor and the first two pending points
+    double au, av, aw, bu, bv, bw, cu, cv, cw;
+    to_plane( anchor, a.plane, au, av, aw );
+    to_plane( pending[0], a.plane, bu, bv, bw );
+    to_plane( pending[1], a.plane, cu, cv, cw );
+    double b1 = bu - au, b2 = bv - av;
+    double c1 = cu - au, c2 = cv - av;
+    double cross = b1*c2 - b2*c1;
+    double b_sq = b1*b1 + b2*b2;
+    double c_sq = c1*c1 + c2*c2;
+    if ( fabs(cross) <= 1e-12*b_sq || fabs(bw - aw) > NORMAL_TOL*tol ) {
+        a.alive = false;
+        return;
+    }
+    // the center, relative to the anchor
+    double ou = ( c2*b_sq - b2*c_sq ) / (2*cross);
+    double ov = ( b1*c_sq - c1*b_sq ) / (2*cross);
+    // the tangent is normal to the radius, toward the first point
+    double tu = ov, tv = -ou;
+    if ( tu*b1 + tv*b2 < 0 ) {
+        tu = -tu;
+        tv = -tv;
+    }
+    double len = sqrt( tu*tu + tv*tv );
+    a.reset( tu/len, tv/len );
+    a.prev = anchor;
+    a.test( anchor, pending[0], 0, tol, maxRadius );
+}
+
+bool ArcCLFilter::check_arc(const ArcFit& a, const Point& c, int k) const {
+    double au, av, aw, cu, cv, cw;
+    to_plane( anchor, a.plane, au, av, aw );
+    to_plane( c, a.plane, cu, cv, cw );
+    double su = au - cu, sv = av - cv;
+    double r = sqrt( su*su + sv*sv );
+    double sign = ( a.kappa > 0 ) ? 1.0 : -1.0;
+    double ptol = PLANE_TOL*tol;
+    double slack = ptol / r;
+    double qu, qv, qw;
+    to_plane( pending[k], a.plane, qu, qv, qw );
+    double sweep = sign*atan2( su*(qv-cv) - sv*(qu-cu), su*(qu-cu) + sv*(qv-cv) );
+    double previous = 0.0;
+    for (int m=0; m<k; ++m) {
+        double pu, pv, pw;
+        to_plane( pending[m], a.plane, pu, pv, pw );
+        pu -= cu;
+        pv -= cv;
+        double angle = sign*atan2( su*pv - sv*pu, su*pu + sv*pv );
+        if ( angle < previous - slack || angle > sweep + slack )
+            return false;
+        if ( fabs( sqrt( pu*pu + pv*pv ) - r ) > ptol*(1+1e-9) )
+            return false;
+        previous = std::max( previous, angle );
+    }
+    return true;
+}
+
+void ArcCLFilter::emit() {
+    // the longest fit that checks out. ties go to lines, and then to tangent-continuous arcs
+    int best;
+    ArcFit* arc;
+    Point center;
+    for (;;) {
+        best = line.last;
+        arc = 0;
+        for (int n=0; n<6; ++n) {
+            int m = ( n < 3 ) ? 2*n : 2*(n-3)+1;
+            if ( fits[m].last > best ) {
+                best = fits[m].last;
+                arc = &fits[m];
+            }
+        }
+        if ( arc == 0 )
+            break;
+        double au, av, aw;
+        to_plane( anchor, arc->plane, au, av, aw );
+        center = from_plane( au - arc->tv/arc->kappa, av + arc->tu/arc->kappa, aw, arc->plane );
+        if ( check_arc( *arc, center, best ) )
+            break;
+        arc->last = -1;
+    }
+    if ( best < 0 ) // the line to the first pending point is always a fit
+        best = 0;
+
+    CLMove m;
+    m.end = pending[best];
+    if ( arc ) {
+        m.arc = true;
+        m.center = center;
+        m.plane = arc->plane;
+        m.ccw = ( arc->kappa > 0 );
+        double eu, ev, ew, cu, cv, cw;
+        to_plane( m.end, arc->plane, eu, ev, ew );
+        to_plane( center, arc->plane, cu, cv, cw );
+        eu -= cu;
+        ev -= cv;
+        double r = sqrt( eu*eu + ev*ev );
+        if ( m.ccw )
+            tangent = from_plane( -ev/r, eu/r, 0.0, arc->plane );
+        else
+            tangent = from_plane( ev/r, -eu/r, 0.0, arc->plane );
+        hasTangent = true;
+    } else {
+        Point d = m.end - anchor;
+        if ( d.norm() > 0.0 ) {
+            tangent = d;
+            tangent.normalize();
+            hasTangent = true;
+        }
+    }
+    moves.push_back( m );
+    anchor = m.end;
+    pending.erase( pending.begin(), pending.begin() + best + 1 );
+    tested = 0;
+    reset();
+}
+
+void ArcCLFilter::LineFit::reset() {
+    alive = true;
+    last = -1;
+    free = true;
+    maxd = 0.0;
+}
+
+void ArcCLFilter::LineFit::test(const Point& anchor, const Point& q, int k, double tol) {
+    Point dir = q - anchor;
+    double d = dir.norm();
+    if ( d > 0.0 )
+        dir *= 1.0/d;
+    // no pending point beyond q, and all of them within tol of the line
+    if ( d < maxd || !( free || ( d > 0.0 && dir.dot(axis) >= cosAngle ) ) ) {
+        alive = false;
+        return;
+    }
+    last = k;
+    if ( d <= tol ) // any direction passes within tol of q
+        return;
+    maxd = d;
+    double a = asin( tol/d );
+    if ( free ) {
+        axis = dir;
+        angle = a;
+        free = false;
+    } else {
+        // the largest cone inside both this cone and the cone of q
+        double theta = acos( std::max( -1.0, std::min( 1.0, axis.dot(dir) ) ) );
+        if ( theta + a <= angle ) {
+            axis = dir;
+            angle = a;
+        } else if ( theta >= angle + a ) { // the cones do not meet
+            alive = false;
+            return;
+        } else if ( theta + angle > a ) {
+            Point w = dir - cos(theta)*axis;
+            double wlen = w.norm();
+            if ( wlen <= 0.0 ) {
+                alive = false;
+                return;
+            }
+            double phi = 0.5*( theta - a + angle );
+            axis = cos(phi)*axis + (sin(phi)/wlen)*w;
+            angle = 0.5*( angle + a - theta );
+        }
+    }
+    cosAngle = cos( angle );
+}
+
+void ArcCLFilter::ArcFit::reset(double u, double v) {
+    alive = true;
+    last = -1;
+    kappa = 0.0;
+    tu = u;
+    tv = v;
+    kmin = -1e300;
+    kmax = 1e300;
+}
+
+void ArcCLFilter::ArcFit::test(const Point& anchor, const Point& q, int k, double tol, double maxRadius) {
+    double au, av, aw, qu, qv, qw, pu, pv, pw;
+    to_plane( anchor, plane, au, av, aw );
+    to_plane( q, plane, qu, qv, qw );
+    to_plane( prev, plane, pu, pv, pw );
+    prev = q;
+    if ( fabs(qw - aw) > NORMAL_TOL*tol ) {
+        alive = false;
+        return;
+    }
+    tol *= PLANE_TOL;
+    // the arc over the chord from the previous point stays within tol of the chord
+    double lu = qu - pu, lv = qv - pv;
+    double l_sq = lu*lu + lv*lv;
+    if ( l_sq > 0.0 ) {
+        kmin = std::max( kmin, -8*tol/l_sq );
+        kmax = std::min( kmax, 8*tol/l_sq );
+    }
+    // q in the frame of the tangent at the anchor
+    double du = qu - au, dv = qv - av;
+    double x = du*tu + dv*tv;
+    double y = dv*tu - du*tv;
+    double d_sq = x*x + y*y;
+    if ( k > 0 ) {
+        // the arc through q, less than a half circle
+        double kq = ( d_sq > 0.0 ) ? 2*y/d_sq : 0.0;
+        if ( x <= 0.0 || kq < kmin || kq > kmax || fabs(kq)*maxRadius < 1.0 ) {
+            alive = false;
+            return;
+        }
+        last = k;
+        kappa = kq;
+    }
+    // the curvatures of the arcs that pass within tol of q
+    if ( d_sq > tol*tol ) {
+        double den = d_sq - tol*tol;
+        kmin = std::max( kmin, 2*(y - tol)/den );
+        kmax = std::min( kmax, 2*(y + tol)/den );
+    }
+    if ( kmin > kmax )
+        alive = false;
+}
+
+} // end namespace
+// end file arcclfilter.cpp
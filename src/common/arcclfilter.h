@@ -0,0 +1,179 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARC_CL_FILTER_H
+#define ARC_CL_FILTER_H
+
+#include <vector>
+
+#include "point.h"
+#include "clpoint.h"
+
+namespace ocl
+{
+
+/// the planes of circular arcs, as G17, G18 and G19 in G-code
+enum ArcPlane {XY_PLANE, XZ_PLANE, YZ_PLANE};
+
+/// \brief a line or a circular arc, from the end of the previous move
+struct CLMove {
+    CLMove() : arc(false), plane(XY_PLANE), ccw(false) {}
+    /// true for an arc, false for a line
+    bool arc;
+    /// the end of the move
+    Point end;
+    /// the center of an arc
+    Point center;
+    /// the plane of an arc
+    ArcPlane plane;
+    /// true for a counterclockwise arc, seen from the positive axis normal to the plane
+    bool ccw;
+};
+
+/// \brief ArcCLFilter replaces a path of CL-points with lines and circular arcs
+///
+/// The points are added in chunks, and the filter keeps only the points of the
+/// line or arc it is currently fitting. Each move ends at an input point, and every
+/// input point is within the tolerance of its move.
+/// Arcs are in the XY, XZ or YZ-plane. The coordinate normal to the plane may change by
+/// a quarter of the tolerance along an arc, so that an arc can end at an input point.
+/// When the path is smooth an arc starts in the direction the previous move ended in,
+/// so consecutive moves are tangent-continuous.
+/// The first move of each path is a line to its first point.
+class ArcCLFilter {
+    public:
+        ArcCLFilter();
+        virtual ~ArcCLFilter() {}
+        /// set the tolerance
+        void setTolerance(double tolerance) {tol = tolerance;}
+        /// fit arcs, or lines only
+        void setArcs(bool a) {arcs = a;}
+        /// set the largest radius of an arc
+        void setMaxRadius(double r) {maxRadius = r;}
+        /// set the number of threads used by filterPaths()
+        void setThreads(unsigned int n) {nthreads = n;}
+        /// add the next n points of the current path
+        void addCLPoints(const CLPoint* p, unsigned int n);
+        /// add the next points of the current path
+        void addCLPoints(const std::vector<CLPoint>& chunk);
+        /// finish the current path. the next point starts a new path
+        void endPath();
+        /// append the finished moves to out, and forget them
+        void takeMoves(std::vector<CLMove>& out);
+        /// filter each path of paths, in parallel. a closed path returns to its first point
+        std::vector< std::vector<CLMove> > filterPaths(const std::vector< std::vector<CLPoint> >& paths,
+                                                       bool closed) const;
+
+    protected:
+        /// a line from the anchor through the pending points
+        ///
+        /// The directions that pass within the tolerance of the pending points are kept as a cone
+        /// (a cap of the unit sphere), so a point is tested in constant time.
+        struct LineFit {
+            /// reset to no pending points
+            void reset();
+            /// a line from anchor to q, with q the pending point k
+            void test(const Point& anchor, const Point& q, int k, double tol);
+            /// false when no later point can end the line
+            bool alive;
+            /// the last pending point the line can end at, or -1
+            int last;
+            /// true when no point constrains the direction yet
+            bool free;
+            /// the axis of the cone
+            Point axis;
+            /// the cosine of the half-angle of the cone
+            double cosAngle;
+            /// the half-angle of the cone
+            double angle;
+            /// the largest distance of a pending point from the anchor
+            double maxd;
+        };
+        /// an arc from the anchor, in a given direction and plane, through the pending points
+        ///
+        /// The arcs tangent to the direction at the anchor have one parameter, the curvature.
+        /// Each pending point limits the curvature to an interval, so a point is tested in constant time.
+        struct ArcFit {
+            /// reset to no pending points, starting along (tu,tv)
+            void reset(double tu, double tv);
+            /// an arc from anchor to q, with q the pending point k
+            void test(const Point& anchor, const Point& q, int k, double tol, double maxRadius);
+            /// false when no later point can end the arc
+            bool alive;
+            /// the last pending point the arc can end at, or -1
+            int last;
+            /// the signed curvature of the arc to the last point, positive counterclockwise
+            double kappa;
+            /// the plane
+            ArcPlane plane;
+            /// the unit tangent at the anchor, in plane coordinates
+            double tu, tv;
+            /// the interval of curvatures through the pending points
+            double kmin, kmax;
+            /// the previous point, for the sagitta of the chord to the next one
+            Point prev;
+        };
+        /// add the next point of the path
+        void add(const Point& p);
+        /// test the pending points that the fits have not seen
+        void process();
+        /// true if some fit can still grow
+        bool alive() const;
+        /// start the fits from the anchor
+        void reset();
+        /// start the arc with the tangent of the circle through the anchor and the first two pending points
+        void start_estimated_arc(ArcFit& a);
+        /// emit the longest fit, and keep the points after it pending
+        void emit();
+        /// true if the pending points up to k are in order on the arc
+        bool check_arc(const ArcFit& a, const Point& c, int k) const;
+
+    // DATA
+        /// the tolerance
+        double tol;
+        /// fit arcs
+        bool arcs;
+        /// the largest radius of an arc
+        double maxRadius;
+        /// the number of threads
+        unsigned int nthreads;
+        /// true when the current path has a first point
+        bool started;
+        /// the end of the last move
+        Point anchor;
+        /// the direction at the end of the last move
+        Point tangent;
+        /// true when the last move was not a single point
+        bool hasTangent;
+        /// the points after the anchor. only the position of a CL-point is kept
+        std::vector<Point> pending;
+        /// the number of pending points tested by the fits
+        unsigned int tested;
+        /// the line fit
+        LineFit line;
+        /// the arc fits: for each plane, one along tangent and one along the estimated tangent
+        ArcFit fits[6];
+        /// the finished moves
+        std::vector<CLMove> moves;
+};
+
+} // end namespace
+#endif
+// end file arcclfilter.h
@@ -0,0 +1,82 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARC_CL_FILTER_PY_H
+#define ARC_CL_FILTER_PY_H
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "arcclfilter.h"
+
+namespace ocl
+{
+
+/// python wrapper for ArcCLFilter
+class ArcCLFilter_py : public ArcCLFilter {
+    public:
+        ArcCLFilter_py() : ArcCLFilter() {}
+        /// add a list of CL-points or Points to the current path
+        void addCLPoints_py(const boost::python::list& plist) {
+            for (int n=0; n<boost::python::len(plist); ++n)
+                add( to_point( plist[n] ) );
+        }
+        /// return the finished moves to python
+        boost::python::list getMoves() {
+            std::vector<CLMove> mv;
+            takeMoves( mv );
+            boost::python::list mlist;
+            BOOST_FOREACH( CLMove m, mv ) {
+                mlist.append( m );
+            }
+            return mlist;
+        }
+        /// filter a list of paths, each a list of CL-points or Points, in parallel
+        boost::python::list filterPaths_py(const boost::python::list& paths, bool closed) const {
+            std::vector< std::vector<CLPoint> > cpaths( boost::python::len(paths) );
+            for (unsigned int n=0; n<cpaths.size(); ++n) {
+                boost::python::list path = boost::python::extract<boost::python::list>( paths[n] );
+                for (int m=0; m<boost::python::len(path); ++m)
+                    cpaths[n].push_back( CLPoint( to_point( path[m] ) ) );
+            }
+            std::vector< std::vector<CLMove> > out = filterPaths( cpaths, closed );
+            boost::python::list plist;
+            BOOST_FOREACH( std::vector<CLMove> mv, out ) {
+                boost::python::list mlist;
+                BOOST_FOREACH( CLMove m, mv ) {
+                    mlist.append( m );
+                }
+                plist.append( mlist );
+            }
+            return plist;
+        }
+    protected:
+        /// the position of a python CLPoint or Point
+        static Point to_point(const boost::python::object& o) {
+            boost::python::extract<CLPoint> cl( o );
+            if ( cl.check() )
+                return cl();
+            return boost::python::extract<Point>( o );
+        }
+};
+
+} // end namespace
+#endif
+// end file arcclfilter_py.h
@@ -0,0 +1,494 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ARENAGRAPH_H
+#define ARENAGRAPH_H
+
+#include <cassert>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace ocl
+{
+
+/// marks an invalid index, and the end of the edge-lists of an ArenaGraph
+const unsigned int ARENA_NIL = 0xFFFFFFFFu;
+
+/// a 32-bit index into the vertex or edge array of an ArenaGraph.
+/// Kind makes vertex and edge descriptors different types, so that
+/// HEDIGraph::operator[] can tell them apart.
+template <int Kind>
+struct ArenaIndex {
+    /// the default index is invalid, like a default-constructed boost descriptor
+    ArenaIndex() : idx(ARENA_NIL) {}
+    /// index i
+    explicit ArenaIndex(unsigned int i) : idx(i) {}
+    /// equality
+    bool operator==(const ArenaIndex& other) const { return idx == other.idx; }
+    /// inequality
+    bool operator!=(const ArenaIndex& other) const { return idx != other.idx; }
+    /// ordering, for std::set and std::map
+    bool operator<(const ArenaIndex& other) const { return idx < other.idx; }
+    /// the position in the array
+    unsigned int idx;
+};
+
+/// print the index
+template <int Kind>
+std::ostream& operator<<(std::ostream& stream, const ArenaIndex<Kind>& i) {
+    return stream << i.idx;
+}
+
+/// \brief a bidirectional graph stored in contiguous arrays
+///
+/// ArenaGraph is an alternative to the boost::adjacency_list< listS, listS, bidirectionalS >
+/// that HEDIGraph is built on. It provides the parts of the BGL interface that the hedi
+/// functions use, see the functions in namespace boost at the end of this file.
+///
+/// Vertices and edges are records in two std::vectors, and the descriptors are 32-bit indices
+/// into these. The out- and in-edges of a vertex are doubly linked lists through the edge records,
+/// in insertion order as with boost::listS, so an edge is removed in constant time.
+/// The slots of removed vertices and edges go on free lists and are reused by later additions.
+/// Iterating over vertices, edges, out-edges, in-edges, and adjacent vertices does not allocate.
+///
+/// Descriptors stay valid until the vertex or edge is removed, also when the arrays grow.
+template <class TVertexProperties, class TEdgeProperties>
+class ArenaGraph {
+    public:
+        typedef ArenaIndex<0> vertex_descriptor;
+        typedef ArenaIndex<1> edge_descriptor;
+        typedef unsigned int vertices_size_type;
+        typedef unsigned int edges_size_type;
+        typedef unsigned int degree_size_type;
+        typedef boost::bidirectional_tag directed_category;
+        typedef boost::allow_parallel_edge_tag edge_parallel_category;
+        /// the BGL traversal concepts of ArenaGraph
+        struct traversal_category : public virtual boost::bidirectional_graph_tag,
+                                    public virtual boost::adjacency_graph_tag,
+                                    public virtual boost::vertex_list_graph_tag,
+                                    public virtual boost::edge_list_graph_tag {};
+        /// the invalid vertex
+        static vertex_descriptor null_vertex() { return vertex_descriptor(); }
+
+    protected:
+        /// a vertex, with the ends of its out- and in-edge lists
+        struct VertexRecord {
+            /// a vertex with properties p and no edges
+            VertexRecord(const TVertexProperties& p) : props(p),
+                out_head(ARENA_NIL), out_tail(ARENA_NIL), in_head(ARENA_NIL), in_tail(ARENA_NIL),
+                out_degree(0), in_degree(0), alive(true) {}
+            /// the vertex properties
+            TVertexProperties props;
+            /// first out-edge
+            unsigned int out_head;
+            /// last out-edge
+            unsigned int out_tail;
+            /// first in-edge
+            unsigned int in_head;
+            /// last in-edge
+            unsigned int in_tail;
+            /// number of out-edges
+            unsigned int out_degree;
+            /// number of in-edges
+            unsigned int in_degree;
+            /// false when the slot is on the free list
+            bool alive;
+        };
+        /// an edge, linked into the out-edge list of its source and the in-edge list of its target
+        struct EdgeRecord {
+            /// an edge from s to t with properties p
+            EdgeRecord(unsigned int s, unsigned int t, const TEdgeProperties& p) : props(p),
+                source(s), target(t),
+                out_next(ARENA_NIL), out_prev(ARENA_NIL), in_next(ARENA_NIL), in_prev(ARENA_NIL), alive(true) {}
+            /// the edge properties
+            TEdgeProperties props;
+            /// source vertex
+            unsigned int source;
+            /// target vertex
+            unsigned int target;
+            /// next out-edge of source
+            unsigned int out_next;
+            /// previous out-edge of source
+            unsigned int out_prev;
+            /// next in-edge of target
+            unsigned int in_next;
+            /// previous in-edge of target
+            unsigned int in_prev;
+            /// false when the slot is on the free list
+            bool alive;
+        };
+
+        /// iterates over the live records of the vertex or edge array
+        template <class Descriptor, class Record>
+        class slot_iterator : public boost::iterator_facade< slot_iterator<Descriptor, Record>,
+                                                             Descriptor, boost::forward_traversal_tag, Descriptor > {
+            public:
+                slot_iterator() : records(0), idx(0) {}
+                /// the first live record at or after i
+                slot_iterator(const std::vector<Record>* r, unsigned int i) : records(r), idx(i) { skip(); }
+            private:
+                friend class boost::iterator_core_access;
+                void skip() {
+                    while ( (idx < records->size()) && !(*records)[idx].alive )
+                        ++idx;
+                }
+                void increment() { ++idx; skip(); }
+                bool equal(const slot_iterator& other) const { return idx == other.idx; }
+                Descriptor dereference() const { return Descriptor(idx); }
+                const std::vector<Record>* records;
+                unsigned int idx;
+        };
+
+        /// iterates over the out-edges (Out=true) or in-edges (Out=false) of a vertex.
+        /// with Adjacent=true the out-edge targets are returned instead of the edges
+        template <class Descriptor, bool Out, bool Adjacent>
+        class list_iterator : public boost::iterator_facade< list_iterator<Descriptor, Out, Adjacent>,
+                                                             Descriptor, boost::forward_traversal_tag, Descriptor > {
+            public:
+                list_iterator() : edges(0), idx(ARENA_NIL) {}
+                /// start at edge i
+                list_iterator(const std::vector<EdgeRecord>* e, unsigned int i) : edges(e), idx(i) {}
+            private:
+                friend class boost::iterator_core_access;
+                void increment() { idx = Out ? (*edges)[idx].out_next : (*edges)[idx].in_next; }
+                bool equal(const list_iterator& other) const { return idx == other.idx; }
+                Descriptor dereference() const { return Descriptor( Adjacent ? (*edges)[idx].target : idx ); }
+                const std::vector<EdgeRecord>* edges;
+                unsigned int idx;
+        };
+
+    public:
+        typedef slot_iterator<vertex_descriptor, VertexRecord> vertex_iterator;
+        typedef slot_iterator<edge_descriptor, EdgeRecord> edge_iterator;
+        typedef list_iterator<edge_descriptor, true, false> out_edge_iterator;
+        typedef list_iterator<edge_descriptor, false, false> in_edge_iterator;
+        typedef list_iterator<vertex_descriptor, true, true> adjacency_iterator;
+
+        ArenaGraph() : n_vertices(0), n_edges(0) {}
+        virtual ~ArenaGraph() {}
+
+        /// reserve space for nv vertices and ne edges
+        void reserve(unsigned int nv, unsigned int ne) {
+            vertex_array.reserve(nv);
+            edge_array.reserve(ne);
+        }
+        /// add a vertex with properties p
+        vertex_descriptor add_vertex(const TVertexProperties& p) {
+            unsigned int i;
+            if ( free_vertices.empty() ) {
+                i = vertex_array.size();
+                vertex_array.push_back( VertexRecord(p) );
+            } else {
+                i = free_vertices.back();
+                free_vertices.pop_back();
+                vertex_array[i] = VertexRecord(p);
+            }
+            ++n_vertices;
+            return vertex_descriptor(i);
+        }
+        /// add an edge u-v with properties p, at the end of the edge-lists of u and v
+        edge_descriptor add_edge(vertex_descriptor u, vertex_descriptor v, const TEdgeProperties& p) {
+            unsigned int i;
+            if ( free_edges.empty() ) {
+                i = edge_array.size();
+                edge_array.push_back( EdgeRecord(u.idx, v.idx, p) );
+            } else {
+                i = free_edges.back();
+                free_edges.pop_back();
+                edge_array[i] = EdgeRecord(u.idx, v.idx, p);
+            }
+            EdgeRecord& e = edge_array[i];
+            VertexRecord& src = vertex_array[u.idx];
+            e.out_prev = src.out_tail;
+            if ( src.out_tail != ARENA_NIL )
+                edge_array[src.out_tail].out_next = i;
+            else
+                src.out_head = i;
+            src.out_tail = i;
+            ++src.out_degree;
+            VertexRecord& trg = vertex_array[v.idx];
+            e.in_prev = trg.in_tail;
+            if ( trg.in_tail != ARENA_NIL )
+                edge_array[trg.in_tail].in_next = i;
+            else
+                trg.in_head = i;
+            trg.in_tail = i;
+            ++trg.in_degree;
+            ++n_edges;
+            return edge_descriptor(i);
+        }
+        /// remove edge e
+        void remove_edge(edge_descriptor e) {
+            EdgeRecord& r = edge_array[e.idx];
+            assert( r.alive );
+            VertexRecord& src = vertex_array[r.source];
+            if ( r.out_prev != ARENA_NIL )
+                edge_array[r.out_prev].out_next = r.out_next;
+            else
+                src.out_head = r.out_next;
+            if ( r.out_next != ARENA_NIL )
+                edge_array[r.out_next].out_prev = r.out_prev;
+            else
+                src.out_tail = r.out_prev;
+            --src.out_degree;
+            VertexRecord& trg = vertex_array[r.target];
+            if ( r.in_prev != ARENA_NIL )
+                edge_array[r.in_prev].in_next = r.in_next;
+            else
+                trg.in_head = r.in_next;
+            if ( r.in_next != ARENA_NIL )
+                edge_array[r.in_next].in_prev = r.in_prev;
+            else
+                trg.in_tail = r.in_prev;
+            --trg.in_degree;
+            r.alive = false;
+            free_edges.push_back(e.idx);
+            --n_edges;
+        }
+        /// remove all u-v edges
+        void remove_edge(vertex_descriptor u, vertex_descriptor v) {
+            unsigned int i = vertex_array[u.idx].out_head;
+            while ( i != ARENA_NIL ) {
+                unsigned int next = edge_array[i].out_next;
+                if ( edge_array[i].target == v.idx )
+                    remove_edge( edge_descriptor(i) );
+                i = next;
+            }
+        }
+        /// the first u-v edge, and true, or false if there is no u-v edge
+        std::pair<edge_descriptor, bool> edge(vertex_descriptor u, vertex_descriptor v) const {
+            for (unsigned int i = vertex_array[u.idx].out_head; i != ARENA_NIL ; i = edge_array[i].out_next) {
+                if ( edge_array[i].target == v.idx )
+                    return std::make_pair( edge_descriptor(i), true );
+            }
+            return std::make_pair( edge_descriptor(), false );
+        }
+        /// remove all edges to and from v
+        void clear_vertex(vertex_descriptor v) {
+            while ( vertex_array[v.idx].out_head != ARENA_NIL )
+                remove_edge( edge_descriptor( vertex_array[v.idx].out_head ) );
+            while ( vertex_array[v.idx].in_head != ARENA_NIL )
+                remove_edge( edge_descriptor( vertex_array[v.idx].in_head ) );
+        }
+        /// remove vertex v, which must not have any edges
+        void remove_vertex(vertex_descriptor v) {
+            VertexRecord& r = vertex_array[v.idx];
+            assert( r.alive );
+            assert( (r.out_head == ARENA_NIL) && (r.in_head == ARENA_NIL) );
+            r.alive = false;
+            free_vertices.push_back(v.idx);
+            --n_vertices;
+        }
+
+        /// source of e
+        vertex_descriptor source(edge_descriptor e) const { return vertex_descriptor( edge_array[e.idx].source ); }
+        /// target of e
+        vertex_descriptor target(edge_descriptor e) const { return vertex_descriptor( edge_array[e.idx].target ); }
+        /// number of out-edges of v
+        degree_size_type out_degree(vertex_descriptor v) const { return vertex_array[v.idx].out_degree; }
+        /// number of in-edges of v
+        degree_size_type in_degree(vertex_descriptor v) const { return vertex_array[v.idx].in_degree; }
+        /// number of vertices
+        vertices_size_type num_vertices() const { return n_vertices; }
+        /// number of edges
+        edges_size_type num_edges() const { return n_edges; }
+
+        /// all vertices
+        std::pair<vertex_iterator, vertex_iterator> vertices() const {
+            return std::make_pair( vertex_iterator( &vertex_array, 0 ), vertex_iterator( &vertex_array, vertex_array.size() ) );
+        }
+        /// all edges
+        std::pair<edge_iterator, edge_iterator> edges() const {
+            return std::make_pair( edge_iterator( &edge_array, 0 ), edge_iterator( &edge_array, edge_array.size() ) );
+        }
+        /// out-edges of v
+        std::pair<out_edge_iterator, out_edge_iterator> out_edges(vertex_descriptor v) const {
+            return std::make_pair( out_edge_iterator( &edge_array, vertex_array[v.idx].out_head ),
+                                   out_edge_iterator( &edge_array, ARENA_NIL ) );
+        }
+        /// in-edges of v
+        std::pair<in_edge_iterator, in_edge_iterator> in_edges(vertex_descriptor v) const {
+            return std::make_pair( in_edge_iterator( &edge_array, vertex_array[v.idx].in_head ),
+                                   in_edge_iterator( &edge_array, ARENA_NIL ) );
+        }
+        /// targets of the out-edges of v
+        std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices(vertex_descriptor v) const {
+            return std::make_pair( adjacency_iterator( &edge_array, vertex_array[v.idx].out_head ),
+                                   adjacency_iterator( &edge_array, ARENA_NIL ) );
+        }
+
+        /// vertex properties
+        TVertexProperties& operator[](vertex_descriptor v) { return vertex_array[v.idx].props; }
+        /// const vertex properties
+        const TVertexProperties& operator[](vertex_descriptor v) const { return vertex_array[v.idx].props; }
+        /// edge properties
+        TEdgeProperties& operator[](edge_descriptor e) { return edge_array[e.idx].props; }
+        /// const edge properties
+        const TEdgeProperties& operator[](edge_descriptor e) const { return edge_array[e.idx].props; }
+
+    protected:
+    // DATA
+        /// the vertices, including removed ones
+        std::vector<VertexRecord> vertex_array;
+        /// the edges, including removed ones
+        std::vector<EdgeRecord> edge_array;
+        /// slots of removed vertices
+        std::vector<unsigned int> free_vertices;
+        /// slots of removed edges
+        std::vector<unsigned int> free_edges;
+        /// number of live vertices
+        unsigned int n_vertices;
+        /// number of live edges
+        unsigned int n_edges;
+};
+
+} // end ocl namespace
+
+// the BGL functions for ArenaGraph, as for boost::adjacency_list
+namespace boost
+{
+
+template <class V, class E>
+typename ocl::ArenaGraph<V,E>::vertex_descriptor add_vertex(ocl::ArenaGraph<V,E>& g) {
+    return g.add_vertex( V() );
+}
+
+template <class V, class E>
+typename ocl::ArenaGraph<V,E>::vertex_descriptor add_vertex(const V& p, ocl::ArenaGraph<V,E>& g) {
+    return g.add_vertex( p );
+}
+
+template <class V, class E>
+std::pair<typename ocl::ArenaGraph<V,E>::edge_descriptor, bool> add_edge( typename ocl::ArenaGraph<V,E>::vertex_descriptor u,
+                                                                        typename ocl::ArenaGraph<V,E>::vertex_descriptor v,
+                                                                        ocl::ArenaGraph<V,E>& g) {
+    return std::make_pair( g.add_edge( u, v, E() ), true );
+}
+
+template <class V, class E>
+std::pair<typename ocl::ArenaGraph<V,E>::edge_descriptor, bool> add_edge( typename ocl::ArenaGraph<V,E>::vertex_descriptor u,
+                                                                        typename ocl::ArenaGraph<V,E>::vertex_descriptor v,
+                                                                        const E& p, ocl::ArenaGraph<V,E>& g) {
+    return std::make_pair( g.add_edge( u, v, p ), true );
+}
+
+template <class V, class E>
+void remove_edge( typename ocl::ArenaGraph<V,E>::edge_descriptor e, ocl::ArenaGraph<V,E>& g) {
+    g.remove_edge( e );
+}
+
+template <class V, class E>
+void remove_edge( typename ocl::ArenaGraph<V,E>::vertex_descriptor u,
+                  typename ocl::ArenaGraph<V,E>::vertex_descriptor v, ocl::ArenaGraph<V,E>& g) {
+    g.remove_edge( u, v );
+}
+
+template <class V, class E>
+std::pair<typename ocl::ArenaGraph<V,E>::edge_descriptor, bool> edge( typename ocl::ArenaGraph<V,E>::vertex_descriptor u,
+                                                                    typename ocl::ArenaGraph<V,E>::vertex_descriptor v,
+                                                                    const ocl::ArenaGraph<V,E>& g) {
+    return g.edge( u, v );
+}
+
+template <class V, class E>
+void clear_vertex( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, ocl::ArenaGraph<V,E>& g) {
+    g.clear_vertex( v );
+}
+
+template <class V, class E>
+void remove_vertex( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, ocl::ArenaGraph<V,E>& g) {
+    g.remove_vertex( v );
+}
+
+template <class V, class E>
+typename ocl::ArenaGraph<V,E>::vertex_descriptor source( typename ocl::ArenaGraph<V,E>::edge_descriptor e,
+                                                         const ocl::ArenaGraph<V,E>& g) {
+    return g.source( e );
+}
+
+template <class V, class E>
+typename ocl::ArenaGraph<V,E>::vertex_descriptor target( typename ocl::ArenaGraph<V,E>::edge_descriptor e,
+                                                         const ocl::ArenaGraph<V,E>& g) {
+    return g.target( e );
+}
+
+template <class V, class E>
+unsigned int out_degree( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, const ocl::ArenaGraph<V,E>& g) {
+    return g.out_degree( v );
+}
+
+template <class V, class E>
+unsigned int in_degree( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, const ocl::ArenaGraph<V,E>& g) {
+    return g.in_degree( v );
+}
+
+/// as for a bidirectional adjacency_list, the degree counts both out- and in-edges
+template <class V, class E>
+unsigned int degree( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, const ocl::ArenaGraph<V,E>& g) {
+    return g.out_degree( v ) + g.in_degree( v );
+}
+
+template <class V, class E>
+unsigned int num_vertices( const ocl::ArenaGraph<V,E>& g) {
+    return g.num_vertices();
+}
+
+template <class V, class E>
+unsigned int num_edges( const ocl::ArenaGraph<V,E>& g) {
+    return g.num_edges();
+}
+
+template <class V, class E>
+std::pair< typename ocl::ArenaGraph<V,E>::vertex_iterator, typename ocl::ArenaGraph<V,E>::vertex_iterator >
+    vertices( const ocl::ArenaGraph<V,E>& g) {
+    return g.vertices();
+}
+
+template <class V, class E>
+std::pair< typename ocl::ArenaGraph<V,E>::edge_iterator, typename ocl::ArenaGraph<V,E>::edge_iterator >
+    edges( const ocl::ArenaGraph<V,E>& g) {
+    return g.edges();
+}
+
+template <class V, class E>
+std::pair< typename ocl::ArenaGraph<V,E>::out_edge_iterator, typename ocl::ArenaGraph<V,E>::out_edge_iterator >
+    out_edges( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, const ocl::ArenaGraph<V,E>& g) {
+    return g.out_edges( v );
+}
+
+template <class V, class E>
+std::pair< typename ocl::ArenaGraph<V,E>::in_edge_iterator, typename ocl::ArenaGraph<V,E>::in_edge_iterator >
+    in_edges( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, const ocl::ArenaGraph<V,E>& g) {
+    return g.in_edges( v );
+}
+
+template <class V, class E>
+std::pair< typename ocl::ArenaGraph<V,E>::adjacency_iterator, typename ocl::ArenaGraph<V,E>::adjacency_iterator >
+    adjacent_vertices( typename ocl::ArenaGraph<V,E>::vertex_descriptor v, const ocl::ArenaGraph<V,E>& g) {
+    return g.adjacent_vertices( v );
+}
+
+} // end boost namespace
+
+#endif
+// end arenagraph.hpp
@@ -0,0 +1,286 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARRAY_PY_H
+#define ARRAY_PY_H
+
+#include <vector>
+#include <sstream>
+#include <cstring>
+
+#include <boost/python.hpp>
+#include <boost/foreach.hpp>
+
+#include "clpoint.h"
+#include "fiber.h"
+
+namespace ocl
+{
+
+/// the elements of an Array
+class ArrayStore {
+    public:
+        virtual ~ArrayStore() {}
+        /// the first element
+        virtual void* data() = 0;
+};
+
+/// the elements of an Array, of type T
+template <class T>
+class ArrayStoreT : public ArrayStore {
+    public:
+        void* data() { return elements.empty() ? NULL : &elements[0]; }
+        /// the elements
+        std::vector<T> elements;
+};
+
+/// the buffer-protocol format of T
+template <class T> struct ArrayFormat;
+/// double
+template <> struct ArrayFormat<double> { static const char* str() { return "d"; } };
+/// unsigned int
+template <> struct ArrayFormat<unsigned int> { static const char* str() { return "I"; } };
+
+/// \brief a one- or two-dimensional array of results, exported to python with the buffer protocol
+///
+/// The results are moved into the array, not copied, and numpy.asarray() or memoryview()
+/// reads them in place. This replaces one python object per point with one object per array.
+struct Array {
+    PyObject_HEAD
+    /// the elements
+    ArrayStore* store;
+    /// the format of an element
+    const char* format;
+    /// the size of an element
+    Py_ssize_t itemsize;
+    /// the number of dimensions, 1 or 2
+    int ndim;
+    /// the number of rows and columns
+    Py_ssize_t shape[2];
+    /// the distances in bytes between rows and columns
+    Py_ssize_t strides[2];
+};
+
+/// free an Array
+inline void array_dealloc(PyObject* self) {
+    delete ((Array*)self)->store;
+    Py_TYPE(self)->tp_free(self);
+}
+
+/// export an Array with the buffer protocol
+inline int array_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    Array* a = (Array*)self;
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = a->store->data();
+    view->itemsize = a->itemsize;
+    view->len = a->shape[0] * ( a->ndim == 2 ? a->shape[1] : 1 ) * a->itemsize;
+    view->readonly = 0;
+    view->format = ( flags & PyBUF_FORMAT ) ? (char*)a->format : NULL;
+    bool nd = ( (flags & PyBUF_ND) == PyBUF_ND );
+    view->ndim = nd ? a->ndim : 1;
+    view->shape = nd ? a->shape : NULL;
+    view->strides = ( (flags & PyBUF_STRIDES) == PyBUF_STRIDES ) ? a->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+/// the python type of Array
+inline PyTypeObject* array_type() {
+    static PyBufferProcs procs;
+    static PyTypeObject type = { PyVarObject_HEAD_INIT(NULL, 0) };
+    if ( !type.tp_name ) {
+        procs.bf_getbuffer = array_getbuffer;
+        type.tp_name = "ocl.Array";
+        type.tp_basicsize = sizeof(Array);
+        type.tp_dealloc = array_dealloc;
+        type.tp_as_buffer = &procs;
+        type.tp_flags = Py_TPFLAGS_DEFAULT;
+#if PY_MAJOR_VERSION < 3
+        type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+        type.tp_doc = "An array of results. Use numpy.asarray() or memoryview() to read it without copying.";
+        PyType_Ready(&type);
+    }
+    return &type;
+}
+
+/// move the elements of v into a new python Array with cols columns, or one dimension if cols is zero.
+/// v is left empty.
+template <class T>
+boost::python::object to_array(std::vector<T>& v, unsigned int cols) {
+    Array* a = PyObject_New(Array, array_type());
+    if ( !a )
+        boost::python::throw_error_already_set();
+    ArrayStoreT<T>* store = new ArrayStoreT<T>();
+    store->elements.swap(v);
+    a->store = store;
+    a->format = ArrayFormat<T>::str();
+    a->itemsize = sizeof(T);
+    a->ndim = ( cols ? 2 : 1 );
+    a->shape[0] = ( cols ? store->elements.size() / cols : store->elements.size() );
+    a->shape[1] = cols;
+    a->strides[0] = ( cols ? cols : 1 ) * sizeof(T);
+    a->strides[1] = sizeof(T);
+    return boost::python::object( boost::python::handle<>( (PyObject*)a ) );
+}
+
+/// an N-by-4 Array of the x, y, z and cc-type of CL-points
+inline boost::python::object clpoint_array(const std::vector<CLPoint>& clpoints) {
+    std::vector<double> xyzt( 4*clpoints.size() );
+    for (unsigned int n=0; n<clpoints.size(); ++n) {
+        xyzt[4*n]   = clpoints[n].x;
+        xyzt[4*n+1] = clpoints[n].y;
+        xyzt[4*n+2] = clpoints[n].z;
+        xyzt[4*n+3] = clpoints[n].cc->type;
+    }
+    return to_array( xyzt, 4 );
+}
+
+/// the loops as a tuple of two Arrays: the offsets of the loops, and N-by-3 coordinates.
+/// loop n is the rows offsets[n] to offsets[n+1]
+inline boost::python::tuple loop_arrays(const std::vector< std::vector<Point> >& loops) {
+    std::vector<unsigned int> offsets(1, 0);
+    BOOST_FOREACH( const std::vector<Point>& loop, loops ) {
+        offsets.push_back( offsets.back() + loop.size() );
+    }
+    std::vector<double> xyz( 3*offsets.back() );
+    unsigned int n = 0;
+    BOOST_FOREACH( const std::vector<Point>& loop, loops ) {
+        BOOST_FOREACH( const Point& p, loop ) {
+            xyz[n++] = p.x;
+            xyz[n++] = p.y;
+            xyz[n++] = p.z;
+        }
+    }
+    return boost::python::make_tuple( to_array( offsets, 0 ), to_array( xyz, 3 ) );
+}
+
+/// the intervals of the fibers as a tuple of two Arrays: the offsets of the fibers, and N-by-6
+/// coordinates of the lower and upper end of each interval. the intervals of fiber n are
+/// the rows offsets[n] to offsets[n+1]
+inline boost::python::tuple fiber_arrays(const std::vector<Fiber>& fibers) {
+    std::vector<unsigned int> offsets(1, 0);
+    BOOST_FOREACH( const Fiber& f, fibers ) {
+        offsets.push_back( offsets.back() + f.ints.size() );
+    }
+    std::vector<double> ends( 6*offsets.back() );
+    unsigned int n = 0;
+    BOOST_FOREACH( const Fiber& f, fibers ) {
+        BOOST_FOREACH( const Interval& i, f.ints ) {
+            Point lower = f.point( i.lower );
+            Point upper = f.point( i.upper );
+            ends[n++] = lower.x;
+            ends[n++] = lower.y;
+            ends[n++] = lower.z;
+            ends[n++] = upper.x;
+            ends[n++] = upper.y;
+            ends[n++] = upper.z;
+        }
+    }
+    return boost::python::make_tuple( to_array( offsets, 0 ), to_array( ends, 6 ) );
+}
+
+/// raise a python ValueError
+inline void value_error(const std::string& msg) {
+    PyErr_SetString( PyExc_ValueError, msg.c_str() );
+    boost::python::throw_error_already_set();
+}
+
+/// true if no coordinate of p is NaN or infinite
+inline bool is_finite(const Point& p) {
+    return p.x-p.x == 0.0 && p.y-p.y == 0.0 && p.z-p.z == 0.0;
+}
+
+/// \brief a python array of numbers, read with the buffer protocol
+///
+/// numpy arrays, and other objects with the buffer protocol, of any number type and with any
+/// strides are accepted. The array must have ndim dimensions, the sizes dim1 and dim2
+/// of the second and third dimension, and any number of rows. A ValueError is raised otherwise.
+class ArrayView {
+    public:
+        /// a view of the python object o
+        ArrayView(const boost::python::object& o, int ndim, Py_ssize_t dim1, Py_ssize_t dim2=0) {
+            if ( PyObject_GetBuffer( o.ptr(), &view, PyBUF_RECORDS_RO ) < 0 )
+                boost::python::throw_error_already_set();
+            const char* f = view.format ? view.format : "B";
+            if ( *f == '@' || *f == '=' )
+                f++;
+            type = ( f[0] && !f[1] ) ? f[0] : 0;
+            std::ostringstream o_err;
+            if ( view.ndim != ndim || view.shape[1] != dim1 || ( ndim == 3 && view.shape[2] != dim2 ) ) {
+                o_err << "expected an N-by-" << dim1;
+                if ( ndim == 3 )
+                    o_err << "-by-" << dim2;
+                o_err << " array";
+            } else if ( !type || !std::strchr( "fdbBhHiIlLqQ", type ) ) {
+                o_err << "expected an array of numbers, not format '" << view.format << "'";
+            }
+            if ( !o_err.str().empty() ) {
+                PyBuffer_Release(&view);
+                value_error( o_err.str() );
+            }
+        }
+        ~ArrayView() {
+            PyBuffer_Release(&view);
+        }
+        /// the number of rows
+        unsigned int size() const { return view.shape[0]; }
+        /// true if the elements are integers
+        bool integer() const { return type != 'f' && type != 'd'; }
+        /// the element (i, j, k)
+        double operator()(unsigned int i, unsigned int j, unsigned int k=0) const {
+            const char* p = (const char*)view.buf + i*view.strides[0] + j*view.strides[1];
+            if ( view.ndim == 3 )
+                p += k*view.strides[2];
+            switch (type) {
+                case 'd': return *(const double*)p;
+                case 'f': return *(const float*)p;
+                case 'b': return *(const signed char*)p;
+                case 'B': return *(const unsigned char*)p;
+                case 'h': return *(const short*)p;
+                case 'H': return *(const unsigned short*)p;
+                case 'i': return *(const int*)p;
+                case 'I': return *(const unsigned int*)p;
+                case 'l': return *(const long*)p;
+                case 'L': return *(const unsigned long*)p;
+                case 'q': return *(const long long*)p;
+                default:  return *(const unsigned long long*)p;
+            }
+        }
+        /// row i as a Point
+        Point point(unsigned int i) const {
+            return Point( (*this)(i,0), (*this)(i,1), (*this)(i,2) );
+        }
+        /// the Point at (i, j)
+        Point point(unsigned int i, unsigned int j) const {
+            return Point( (*this)(i,j,0), (*this)(i,j,1), (*this)(i,j,2) );
+        }
+    protected:
+        /// the buffer of the python object
+        Py_buffer view;
+        /// the format of an element
+        char type;
+};
+
+} // end namespace
+#endif
+// end file array_py.h
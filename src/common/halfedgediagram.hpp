@@ -20,6 +20,7 @@
 #ifndef HEDI2_H
 #define HEDI2_H
 
+#include <cassert>
 #include <vector>
 #include <list>
 
@@ -28,6 +29,7 @@
 
 #include "point.h"
 #include "numeric.h"
+#include "arenagraph.hpp"
 namespace ocl
 {
     
@@ -61,7 +63,8 @@ namespace ocl
 /// attaching information to vertices/edges/faces that is 
 /// required for a particular algorithm.
 /// 
-/// Inherits from boost::adjacency_list
+/// Inherits from boost::adjacency_list, or from ArenaGraph when the
+/// storage selectors are arenaS (see below).
 /// minor additions allow storing face-properties.
 ///
 /// the hedi namespace contains functions for manipulating HEDIGraphs
@@ -111,6 +114,40 @@ class HEDIGraph : public boost::adjacency_list< TOutEdgeList,           // out-e
         std::vector< TFaceProperties > faces;
 };
 
+/// storage selector for HEDIGraph. When arenaS is given for the out-edge, vertex, and edge
+/// storage, the graph is an ArenaGraph instead of a boost::adjacency_list.
+/// The graph is then allways bidirectional.
+struct arenaS {};
+
+/// HEDIGraph with contiguous arena storage, see ArenaGraph.
+/// The hedi functions work on it as on the adjacency_list based HEDIGraph.
+template <class TDirected, 
+          class TVertexProperties,
+          class TEdgeProperties,
+          class TFaceProperties,
+          class TGraphProperties
+          >
+class HEDIGraph< arenaS, arenaS, TDirected, 
+                 TVertexProperties, TEdgeProperties, TFaceProperties, TGraphProperties,
+                 arenaS > : public ArenaGraph< TVertexProperties, TEdgeProperties >
+{
+    public:
+        typedef unsigned int HEFace; 
+        typedef ArenaGraph< TVertexProperties, TEdgeProperties > BGLGraph;
+        /// use base class operator[] for vertex and edge properties
+        using BGLGraph::operator[]; 
+        /// operator[] to access face properties
+        TFaceProperties& operator[](HEFace f)  { 
+            return faces[f]; 
+        }
+        /// const operator[] for accessing face properties
+        const TFaceProperties& operator[](HEFace f) const  { 
+            return faces[f]; 
+        }
+//DATA
+        std::vector< TFaceProperties > faces;
+};
+
 // FIXME: why is the class outside the namespace but the functions are inside?
 namespace hedi  { // collect half-edge diagram functions here.
 
@@ -181,33 +218,22 @@ typename boost::graph_traits< Graph >::vertex_descriptor source( typename boost:
     return boost::source( e, g); 
 }
 
-/// return all vertices in a vector of vertex descriptors
+// the iteration functions below return a pair of iterators, which BOOST_FOREACH
+// accepts as a range. Nothing is allocated, so the graph must not be changed
+// while iterating.
+
+/// return all vertices, as a pair of vertex iterators
 template<class Graph>
-typename std::vector< typename boost::graph_traits<Graph>::vertex_descriptor > vertices(const Graph& g)  {
-    typedef typename boost::graph_traits< Graph >::vertex_descriptor  HEVertex;
-    typedef std::vector<HEVertex> VertexVector;
-    typedef typename boost::graph_traits< Graph >::vertex_iterator    HEVertexItr;
-    VertexVector vv;
-    HEVertexItr it_begin, it_end, itr;
-    boost::tie( it_begin, it_end ) = boost::vertices( g );
-    for ( itr=it_begin ; itr != it_end ; ++itr ) {
-        vv.push_back( *itr );
-    }
-    return vv;
+std::pair< typename boost::graph_traits<Graph>::vertex_iterator, typename boost::graph_traits<Graph>::vertex_iterator > 
+    vertices(const Graph& g)  {
+    return boost::vertices( g );
 }
 
-/// return all vertices adjecent to given vertex
+/// return all vertices adjecent to given vertex, i.e. the targets of its out-edges
 template <class Graph>
-typename std::vector< typename boost::graph_traits< Graph >::vertex_descriptor > 
-    adjacent_vertices(  typename boost::graph_traits< Graph >::vertex_descriptor v, Graph& g) {
-    typedef typename boost::graph_traits< Graph >::vertex_descriptor  HEVertex;
-    typedef typename boost::graph_traits< Graph >::edge_descriptor    HEEdge;
-    typedef std::vector<HEVertex> VertexVector;
-    VertexVector vv;
-    BOOST_FOREACH( HEEdge edge, out_edges( v , g) ) {
-        vv.push_back( target( edge , g) );
-    }
-    return vv;
+std::pair< typename boost::graph_traits<Graph>::adjacency_iterator, typename boost::graph_traits<Graph>::adjacency_iterator > 
+    adjacent_vertices(  typename boost::graph_traits< Graph >::vertex_descriptor v, const Graph& g) {
+    return boost::adjacent_vertices( v, g );
 }
 
 /// return all vertices of given face
@@ -245,35 +271,18 @@ unsigned int num_vertices(const Graph& g) {
     return boost::num_vertices( g ); 
 }
 
-/// return out_edges of given vertex
+/// return out_edges of given vertex, as a pair of out-edge iterators
 template <class Graph>
-typename std::vector< typename boost::graph_traits< Graph >::edge_descriptor > out_edges( 
-        typename boost::graph_traits< Graph >::vertex_descriptor v , const Graph& g)  {
-    typedef typename boost::graph_traits< Graph >::edge_descriptor  HEEdge;
-    typedef std::vector<HEEdge> EdgeVector;  
-    typedef typename boost::graph_traits< Graph >::out_edge_iterator  HEOutEdgeItr;
-    EdgeVector ev;
-    HEOutEdgeItr it, it_end;
-    boost::tie( it, it_end ) = boost::out_edges( v, g );
-    for ( ; it != it_end ; ++it ) {
-        ev.push_back(*it);
-    }
-    return ev;
+std::pair< typename boost::graph_traits<Graph>::out_edge_iterator, typename boost::graph_traits<Graph>::out_edge_iterator > 
+    out_edges( typename boost::graph_traits< Graph >::vertex_descriptor v , const Graph& g)  {
+    return boost::out_edges( v, g );
 }
 
-/// return all edges
+/// return all edges, as a pair of edge iterators
 template <class Graph>
-typename std::vector< typename boost::graph_traits< Graph >::edge_descriptor  >  edges(Graph& g) {
-    typedef typename boost::graph_traits< Graph >::edge_descriptor  HEEdge;
-    typedef typename std::vector< HEEdge > EdgeVector;
-    typedef typename boost::graph_traits< Graph >::edge_iterator      HEEdgeItr; 
-    EdgeVector ev;
-    HEEdgeItr it, it_end;
-    boost::tie( it, it_end ) = boost::edges( g );
-    for ( ; it != it_end ; ++it ) {
-        ev.push_back(*it);
-    }
-    return ev;
+std::pair< typename boost::graph_traits<Graph>::edge_iterator, typename boost::graph_traits<Graph>::edge_iterator > 
+    edges(const Graph& g) {
+    return boost::edges( g );
 }
         
         
@@ -292,15 +301,21 @@ typename std::vector< typename boost::graph_traits< Graph >::edge_descriptor  >
     return out;
 }
 
-/// return the previous edge. traverses all edges in face until previous found.
+/// set the next-pointer of edge e to n, and the prev-pointer of n to e.
+/// all next-pointers must be set with this function, so that previous_edge() is correct
+template <class Graph>
+void set_next( typename boost::graph_traits< Graph >::edge_descriptor e, 
+               typename boost::graph_traits< Graph >::edge_descriptor n, Graph& g) {
+    g[e].next = n;
+    g[n].prev = e;
+}
+
+/// return the previous edge, the edge whose next-pointer is e
 template <class Graph>
 typename boost::graph_traits< Graph >::edge_descriptor previous_edge(
                       typename boost::graph_traits< Graph >::edge_descriptor e, Graph& g) {
-    typename boost::graph_traits< Graph >::edge_descriptor previous = g[e].next;
-    while ( g[previous].next != e ) {
-        previous = g[previous].next;
-    }
-    return previous;
+    assert( g[ g[e].prev ].next == e ); // the next-pointers must be set with set_next()
+    return g[e].prev;
 }
 
 
@@ -396,9 +411,9 @@ void insert_vertex_in_edge(typename boost::graph_traits< Graph >::vertex_descrip
     g[e1].face = face;
     g[e2].face = face;
     // next-pointers
-    g[previous].next = e1;
-    g[e1].next = e2;
-    g[e2].next = g[e].next;
+    set_next( previous, e1, g );
+    set_next( e1, e2, g );
+    set_next( e2, g[e].next, g );
     
     
     HEEdge te1 = add_edge( twin_source, v  , g);
@@ -407,9 +422,9 @@ void insert_vertex_in_edge(typename boost::graph_traits< Graph >::vertex_descrip
     g[te1].face = twin_face;
     g[te2].face = twin_face;
     
-    g[twin_previous].next = te1;
-    g[te1].next = te2;
-    g[te2].next = g[twin].next;
+    set_next( twin_previous, te1, g );
+    set_next( te1, te2, g );
+    set_next( te2, g[twin].next, g );
     
     // TWINNING (note indices 'cross', see ASCII art above)
     g[e1].twin = te2;
@@ -450,9 +465,9 @@ void insert_vertex_in_half_edge(typename boost::graph_traits< Graph >::vertex_de
     g[e1].face = face;
     g[e2].face = face;
     // next-pointers
-    g[previous].next = e1;
-    g[e1].next = e2;
-    g[e2].next = g[e].next;
+    set_next( previous, e1, g );
+    set_next( e1, e2, g );
+    set_next( e2, g[e].next, g );
     // update the faces (required here?)
     g.faces[face].edge = e1;
     // finally, remove the old edge
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <list>
+#include <sstream>
 
 namespace ocl
 {
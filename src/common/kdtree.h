@@ -21,6 +21,8 @@
 #ifndef KDTREE_H
 #define KDTREE_H
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <list>
 
@@ -30,6 +32,7 @@
 #include "bbox.h"
 #include "millingcutter.h"
 #include "clpoint.h"
+#include "numeric.h"
 
 namespace ocl
 {
@@ -72,7 +75,7 @@ class Spread {
 template <class BBObj>
 class KDTree {
     public:
-        KDTree() {};
+        KDTree() : root(NULL) {}
         virtual ~KDTree() {
             // std::cout << " ~KDTree()\n";
             delete root;
@@ -109,6 +112,17 @@ class KDTree {
             dimensions.push_back(4); // z
             dimensions.push_back(5); // z
         } // for Y-fibers
+        /// search in all three dimensions
+        void setXYZDimensions(){ // for fibers searched in segments
+            std::cout << "KDTree::setXYZDimensions()\n";
+            dimensions.clear();
+            dimensions.push_back(0); // x
+            dimensions.push_back(1); // x
+            dimensions.push_back(2); // y
+            dimensions.push_back(3); // y
+            dimensions.push_back(4); // z
+            dimensions.push_back(5); // z
+        } 
         /// build the kd-tree based on a list of input objects
         void build(const std::list<BBObj>& list){
             std::cout << "KDTree::build() list.size()= " << list.size() << " \n";
@@ -116,17 +130,41 @@ class KDTree {
         }
         /// search for overlap with input Bbox bb, return found objects
         std::list<BBObj>* search( const Bbox& bb ){
+            unsigned long nodes = 0;
+            return this->search( bb, nodes );
+        }
+        /// search for overlap with input Bbox bb, return found objects.
+        /// the number of KDNodes visited by the search is added to nodes.
+        std::list<BBObj>* search( const Bbox& bb, unsigned long& nodes ){
             assert( !dimensions.empty() );
             std::list<BBObj>* tris = new std::list<BBObj>();
-            this->search_node( tris, bb, root );
+            this->search_node( tris, bb, root, nodes );
             return tris;
         }
         /// search for overlap with a MillingCutter c positioned at cl, return found objects
         std::list<BBObj>* search_cutter_overlap(const MillingCutter* c, CLPoint* cl ){
+            return this->search( cutter_bbox(c, cl) );
+        }
+        /// search for overlap with a MillingCutter c positioned at cl, count visited nodes
+        std::list<BBObj>* search_cutter_overlap(const MillingCutter* c, CLPoint* cl, unsigned long& nodes ){
+            return this->search( cutter_bbox(c, cl), nodes );
+        }
+        /// return the bounding-box of MillingCutter c positioned at cl
+        static Bbox cutter_bbox(const MillingCutter* c, const CLPoint* cl) {
             double r = c->getRadius();
-            // build a bounding-box at the current CL
-            Bbox bb( cl->x-r, cl->x+r, cl->y-r, cl->y+r, cl->z, cl->z+c->getLength() );    
-            return this->search( bb );
+            return Bbox( cl->x-r, cl->x+r, cl->y-r, cl->y+r, cl->z, cl->z+c->getLength() );
+        }
+        /// return true if the bounding-box of o overlaps with bb along the
+        /// search-dimensions of this tree. This is the cheap test used to filter
+        /// the shared result of a packet-search for each member of the packet.
+        bool overlaps( const Bbox& bb, const BBObj& o ) const {
+            for (unsigned int m=0;m<dimensions.size();m+=2) { // dimensions come in (min,max) pairs
+                if ( o.bb[ dimensions[m+1] ] < bb[ dimensions[m] ] )
+                    return false;
+                if ( o.bb[ dimensions[m] ] > bb[ dimensions[m+1] ] )
+                    return false;
+            }
+            return true;
         }
         /// string repr
         std::string str() const;
@@ -251,8 +289,9 @@ class KDTree {
         
         
         /// search kd-tree starting at *node, looking for overlap with bb, and placing
-        /// found objects in *tris
-        void search_node( std::list<BBObj> *tris, const Bbox& bb, KDNode<BBObj> *node) {
+        /// found objects in *tris. nodes counts the number of visited KDNodes.
+        void search_node( std::list<BBObj> *tris, const Bbox& bb, KDNode<BBObj> *node, unsigned long& nodes) {
+            ++nodes;
             if (node->isLeaf ) { // we found a bucket node, so add all triangles and return.
             
                 BOOST_FOREACH( BBObj t, *(node->tris) ) {
@@ -264,22 +303,22 @@ class KDTree {
                 // not a bucket node, so recursevily seach hi/lo branches of KDNode
                 unsigned int maxdim = node->dim+1;
                 if ( node->cutval > bb[maxdim] ) { // search only lo
-                    search_node(tris, bb, node->lo );
+                    search_node(tris, bb, node->lo, nodes);
                 } else { // need to search both child nodes
                     if (node->hi)
-                        search_node(tris, bb, node->hi );
+                        search_node(tris, bb, node->hi, nodes);
                     if (node->lo)
-                        search_node(tris, bb, node->lo );
+                        search_node(tris, bb, node->lo, nodes);
                 }
             } else { // cutting along a max-dimension: 1,3,5
                 unsigned int mindim = node->dim-1;
                 if ( node->cutval < bb[mindim] ) { // search only hi
-                    search_node(tris, bb, node->hi);
+                    search_node(tris, bb, node->hi, nodes);
                 } else { // need to search both child nodes
                     if (node->hi)
-                        search_node(tris, bb, node->hi);
+                        search_node(tris, bb, node->hi, nodes);
                     if (node->lo)
-                        search_node(tris, bb, node->lo);
+                        search_node(tris, bb, node->lo, nodes);
                 }
             }
             return; // Done. We get here after all the recursive calls above.
@@ -21,6 +21,7 @@
 #ifndef BALL_CUTTER_H
 #define BALL_CUTTER_H
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
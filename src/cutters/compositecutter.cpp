@@ -18,6 +18,8 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
+
 #include "compositecutter.h"
 #include "numeric.h"
 #include "cylcutter.h"
@@ -18,11 +18,14 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
+
 #include <boost/foreach.hpp>
 
 #include "conecutter.h"
 #include "compositecutter.h" // for offsetCutter()
 #include "numeric.h"
+#include "slicedtriangle.h"
 
 namespace ocl
 {
@@ -138,6 +141,17 @@ bool ConeCutter::facetPush(const Fiber& fib, Interval& i,  const Triangle& t) co
     return result;
 }
 
+bool ConeCutter::facetPush(const Fiber& fib, Interval& i,  const SlicedTriangle& t) const {
+    bool result = false;
+    if ( t.horizontal )
+        return result;
+    if ( generalFacetPush( 0, 0, 0, fib, i, t, t.normal, t.xy_normal) ) // TIP
+        result = true;
+    if ( generalFacetPush( 0, this->center_height, this->xy_normal_length , fib, i ,t, t.normal, t.xy_normal) ) // BASE
+        result = true;
+    return result;
+}
+
 // cone is pushed along Fiber f into contact with edge p1-p2
 bool ConeCutter::generalEdgePush(const Fiber& f, Interval& i,  const Point& p1, const Point& p2) const {
     bool result = false;
@@ -52,6 +52,7 @@ class ConeCutter : public MillingCutter {
         CC_CLZ_Pair singleEdgeDropCanonical( const Point& u1, const Point& u2) const;
         
         bool facetPush(const Fiber& fib, Interval& i,  const Triangle& t) const;
+        bool facetPush(const Fiber& fib, Interval& i,  const SlicedTriangle& t) const;
             
         bool generalEdgePush(const Fiber& f, Interval& i,  const Point& p1, const Point& p2) const;
         
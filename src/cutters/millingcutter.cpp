@@ -18,10 +18,13 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
+
 #include <boost/foreach.hpp>
 
 #include "millingcutter.h"
 #include "numeric.h"
+#include "slicedtriangle.h"
 
 namespace ocl
 {
@@ -134,6 +137,26 @@ bool MillingCutter::vertexPush(const Fiber& f, Interval& i, const Triangle& t) c
     return result;
 }
 
+// the same as vertexPush(), with the z-slice computed once per z-height
+bool MillingCutter::vertexPush(const Fiber& f, Interval& i, const SlicedTriangle& t) const {
+    bool result = false;
+    BOOST_FOREACH( const Point& p, t.p) {
+        if (this->singleVertexPush(f,i,p, VERTEX) )
+            result = true;
+    }
+    if ( this->vertexPushTriangleSlice() && t.sliced ) {
+        Point p1 = t.s1;
+        Point p2 = t.s2;
+        p1.z = p1.z + 1E-3; // the same trick as in vertexPush()
+        p2.z = p2.z + 1E-3;
+        if ( this->singleVertexPush(f,i,p1, VERTEX_CYL) )
+            result = true;
+        if (this->singleVertexPush(f,i,p2, VERTEX_CYL))
+            result = true;
+    }
+    return result;
+}
+
 bool MillingCutter::singleVertexPush(const Fiber& f, Interval& i, const Point& p, CCType cctyp) const {
     bool result = false;
     if ( ( p.z > f.p1.z ) && ( p.z <= (f.p1.z+ this->getLength()) ) ) { // p.z is within cutter
@@ -161,6 +184,15 @@ bool MillingCutter::facetPush(const Fiber& fib, Interval& i,  const Triangle& t)
                             this->xy_normal_length,
                             fib,i,t);
 }
+
+bool MillingCutter::facetPush(const Fiber& fib, Interval& i,  const SlicedTriangle& t) const {
+    if ( t.horizontal )
+        return false;
+    return generalFacetPush(this->normal_length,
+                            this->center_height,
+                            this->xy_normal_length,
+                            fib,i,t,t.normal,t.xy_normal);
+}
     
 // general purpose facetPush
 bool MillingCutter::generalFacetPush(double normal_length,
@@ -170,15 +202,26 @@ bool MillingCutter::generalFacetPush(double normal_length,
                                      Interval& i,  
                                      const Triangle& t) 
                                      const {
-    bool result = false;
     Point normal = t.upNormal(); // facet surface normal, pointing up 
     if ( normal.zParallel() ) // normal points in z-dir   
-        return result; //can't push against horizontal plane, stop here.
+        return false; //can't push against horizontal plane, stop here.
     normal.normalize();
     Point xy_normal = normal;
     xy_normal.z = 0;
     xy_normal.xyNormalize();
-    
+    return generalFacetPush(normal_length, center_height, xy_normal_length, fib, i, t, normal, xy_normal);
+}
+
+bool MillingCutter::generalFacetPush(double normal_length,
+                                     double center_height,
+                                     double xy_normal_length,
+                                     const Fiber& fib, 
+                                     Interval& i,  
+                                     const Triangle& t,
+                                     const Point& normal,
+                                     const Point& xy_normal) 
+                                     const {
+    bool result = false;
     //   find a point on the plane from which radius2*normal+radius1*xy_normal lands on the fiber+radius2*Point(0,0,1) 
     //   (u,v) locates a point on the triangle facet    v0+ u*(v1-v0)+v*(v2-v0)    u,v in [0,1]
     //   t locates a point along the fiber:             p1 + t*(p2-p1)             t in [0,1]
@@ -377,6 +420,13 @@ bool MillingCutter::pushCutter(const Fiber& f, Interval& i, const Triangle& t) c
     return v || fa || e;
 }
 
+bool MillingCutter::pushCutter(const Fiber& f, Interval& i, const SlicedTriangle& t) const {
+    bool v = vertexPush(f,i,t); 
+    bool fa = facetPush(f,i,t);
+    bool e = edgePush(f,i,t);
+    return v || fa || e;
+}
+
 
 // call vertex, facet, and edge drop methods on input Triangle t
 bool MillingCutter::dropCutter(CLPoint &cl, const Triangle &t) const {
@@ -21,7 +21,9 @@
 #ifndef MILLING_CUTTER_H
 #define MILLING_CUTTER_H
 
+#include <cassert>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -35,6 +37,7 @@ namespace ocl
 {
 
 class Triangle;
+class SlicedTriangle;
 class STLSurf;
 
 typedef std::pair< double, double > CC_CLZ_Pair;
@@ -88,6 +91,8 @@ class MillingCutter {
         
         /// push cutter against triangle using vertexPush, facetPush, and edgePush
         bool pushCutter(const Fiber& f, Interval& i, const Triangle& t) const;
+        /// push cutter against triangle, using the data precomputed for the z-height of Fiber f
+        bool pushCutter(const Fiber& f, Interval& i, const SlicedTriangle& t) const;
         
         /// return a string representation of the MillingCutter
         virtual std::string str() const {return "MillingCutter (all derived classes should override this)";}
@@ -99,8 +104,12 @@ class MillingCutter {
         /// updates Interval i with the interfering interval.
         /// calls singleVertexPush() on the three vertices of Triangle t
         virtual bool vertexPush(const Fiber& f, Interval& i, const Triangle& t) const;
+        /// vertexPush() which uses the precomputed z-slice of t
+        bool vertexPush(const Fiber& f, Interval& i, const SlicedTriangle& t) const;
         /// push cutter along Fiber f into contact with facet of Triangle t, and update Interval i
         virtual bool facetPush(const Fiber& f, Interval& i, const Triangle& t) const;
+        /// facetPush() which uses the precomputed normal of t
+        virtual bool facetPush(const Fiber& f, Interval& i, const SlicedTriangle& t) const;
         bool generalFacetPush(double normal_length,
                                      double center_height,
                                      double xy_normal_length,
@@ -108,6 +117,16 @@ class MillingCutter {
                                      Interval& i,  
                                      const Triangle& t) 
                                      const;
+        /// generalFacetPush() with the normalized facet normal, and its normalized xy-projection, given
+        bool generalFacetPush(double normal_length,
+                                     double center_height,
+                                     double xy_normal_length,
+                                     const Fiber& fib, 
+                                     Interval& i,  
+                                     const Triangle& t,
+                                     const Point& normal,
+                                     const Point& xy_normal) 
+                                     const;
                                          
         /// push cutter along Fiber f into contact with edges of Triangle t, update Interval i
         /// calls singleEdgePush() on all three edges of Triangle t.
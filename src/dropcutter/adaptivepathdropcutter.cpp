@@ -20,6 +20,10 @@
 
 #include <boost/foreach.hpp>
 
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
 #include "millingcutter.h"
 #include "clpoint.h"
 #include "pointdropcutter.h"
@@ -40,6 +44,11 @@ AdaptivePathDropCutter::AdaptivePathDropCutter() {
     sampling = 0.1;
     min_sampling = 0.01;
     cosLimit = 0.999;
+    taskDepth = 6;
+    nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_num_procs();
+#endif
 }
 
 AdaptivePathDropCutter::~AdaptivePathDropCutter() {
@@ -51,22 +60,41 @@ void AdaptivePathDropCutter::run() {
     adaptive_sampling_run();
 }
 
+// spans don't depend on each other, so each span is sampled by its own OpenMP task
+// into a separate vector. The vectors are joined in path-order when all tasks are done,
+// so the result is identical to a serial run.
 void AdaptivePathDropCutter::adaptive_sampling_run() {
     std::cout << " apdc::adaptive_sampling_run()... ";
     
     clpoints.clear();
-    BOOST_FOREACH( const Span* span, path->span_list ) {  // this loop could run in parallel, since spans don't depend on eachother
-        CLPoint start = span->getPoint(0.0);
-        CLPoint stop = span->getPoint(1.0);
-        subOp[0]->run(start);
-        subOp[0]->run(stop);
-        clpoints.push_back(start);
-        adaptive_sample( span, 0.0, 1.0, start, stop);
+    std::vector<const Span*> spans( path->span_list.begin(), path->span_list.end() );
+    std::vector< std::vector<CLPoint> > span_clpoints( spans.size() );
+    #pragma omp parallel num_threads(nthreads) shared(spans, span_clpoints)
+    {
+        #pragma omp single
+        {
+            for (unsigned int n=0; n<spans.size(); ++n) {
+                #pragma omp task firstprivate(n) shared(spans, span_clpoints)
+                {
+                    const Span* span = spans[n];
+                    CLPoint start = span->getPoint(0.0);
+                    CLPoint stop = span->getPoint(1.0);
+                    subOp[0]->run(start);
+                    subOp[0]->run(stop);
+                    span_clpoints[n].push_back(start);
+                    adaptive_sample( span, 0.0, 1.0, start, stop, span_clpoints[n], 0);
+                }
+            }
+        } // implicit barrier, all tasks are done here
+    }
+    BOOST_FOREACH( std::vector<CLPoint>& span_points, span_clpoints ) {
+        clpoints.insert( clpoints.end(), span_points.begin(), span_points.end() );
     }
     std::cout << " DONE clpoints.size()=" << clpoints.size() << "\n";
 }
 
-void AdaptivePathDropCutter::adaptive_sample(const Span* span, double start_t, double stop_t, CLPoint start_cl, CLPoint stop_cl) {
+void AdaptivePathDropCutter::adaptive_sample(const Span* span, double start_t, double stop_t, CLPoint start_cl, CLPoint stop_cl, 
+                                             std::vector<CLPoint>& out, int depth) {
     const double mid_t = start_t + (stop_t-start_t)/2.0; // mid point sample
     assert( mid_t > start_t );  assert( mid_t < stop_t );
     CLPoint mid_cl = span->getPoint(mid_t);
@@ -75,10 +103,22 @@ void AdaptivePathDropCutter::adaptive_sample(const Span* span, double start_t, d
     double fw_step = (stop_cl-start_cl).xyNorm();
     if ( (fw_step > sampling) || // above minimum step-forward, need to sample more
           ( (!flat(start_cl,mid_cl,stop_cl)) && (fw_step > min_sampling) ) ) { // OR not flat, and not max sampling
-        adaptive_sample( span, start_t, mid_t , start_cl, mid_cl  );
-        adaptive_sample( span, mid_t  , stop_t, mid_cl  , stop_cl );
+        if ( depth < taskDepth ) { // sample the two halves in parallel
+            std::vector<CLPoint> lo_out;
+            std::vector<CLPoint> hi_out;
+            #pragma omp task shared(lo_out)
+            adaptive_sample( span, start_t, mid_t , start_cl, mid_cl, lo_out, depth+1 );
+            #pragma omp task shared(hi_out)
+            adaptive_sample( span, mid_t  , stop_t, mid_cl  , stop_cl, hi_out, depth+1 );
+            #pragma omp taskwait
+            out.insert( out.end(), lo_out.begin(), lo_out.end() );
+            out.insert( out.end(), hi_out.begin(), hi_out.end() );
+        } else {
+            adaptive_sample( span, start_t, mid_t , start_cl, mid_cl, out, depth+1 );
+            adaptive_sample( span, mid_t  , stop_t, mid_cl  , stop_cl, out, depth+1 );
+        }
     } else {
-        clpoints.push_back(stop_cl); 
+        out.push_back(stop_cl); 
     }
 }
 
@@ -70,8 +70,11 @@ class AdaptivePathDropCutter : public Operation {
             subOp[0]->clearCLPoints();
         }
     protected:
-        /// run adaptive sample on the given Span between t-values of start_t and stop_t
-        void adaptive_sample(const Span* span, double start_t, double stop_t, CLPoint start_cl, CLPoint stop_cl);
+        /// run adaptive sample on the given Span between t-values of start_t and stop_t.
+        /// the sampled CL-points are appended to out. Above taskDepth levels of recursion
+        /// the two halves of the subdivision run as separate OpenMP tasks.
+        void adaptive_sample(const Span* span, double start_t, double stop_t, CLPoint start_cl, CLPoint stop_cl, 
+                             std::vector<CLPoint>& out, int depth);
         /// flatness predicate for adaptive sampling
         bool flat(CLPoint& start_cl, CLPoint& mid_cl, CLPoint& stop_cl);
         /// run adaptive sampling
@@ -81,6 +84,8 @@ class AdaptivePathDropCutter : public Operation {
         double min_sampling;
         /// the limit for dot-product used in flat()
         double cosLimit;
+        /// recursion depth below which adaptive_sample() no longer creates new tasks
+        int taskDepth;
         const Path* path;
         double minimumZ;
         std::vector<CLPoint> clpoints;
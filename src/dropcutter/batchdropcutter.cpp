@@ -18,9 +18,22 @@
  *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+#include <boost/cstdint.hpp>
 #include <boost/foreach.hpp>
 #include <boost/progress.hpp>
 
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
 #ifdef _OPENMP // this should really not be a check for Windows, but a check for OpenMP
     #include <omp.h>
 #endif
@@ -43,6 +56,8 @@ BatchDropCutter::BatchDropCutter() {
 #endif
     cutter = NULL;
     bucketSize = 1;
+    packetSize = 8;
+    chunkSize = 1000000;
     root = new KDTree<Triangle>();
 }
 
@@ -143,12 +158,8 @@ void BatchDropCutter::dropCutter4() {
     std::vector<CLPoint>& clref = *clpoints; 
     int nloop=0;
     unsigned int ntriangles = surf->tris.size();
-#ifdef _OPENMP
-    omp_set_num_threads(nthreads); // the constructor sets number of threads right
-                                   // or the user can explicitly specify something else
-#endif
     std::list<Triangle>::iterator it;
-    #pragma omp parallel for shared( nloop, ntris, calls, clref) private(n,tris,it)
+    #pragma omp parallel for num_threads(nthreads) shared( nloop, ntris, calls, clref) private(n,tris,it)
         for (n=0;n< Nmax ;n++) { // PARALLEL OpenMP loop!
 #ifdef _OPENMP
             if ( n== 0 ) { // first iteration
@@ -202,12 +213,8 @@ void BatchDropCutter::dropCutter5() {
     std::vector<CLPoint>& clref = *clpoints; 
     int nloop=0;
     unsigned int ntriangles = surf->tris.size();
-#ifdef _OPENMP
-    omp_set_num_threads(nthreads); // the constructor sets number of threads right
-                                   // or the user can explicitly specify something else
-#endif
     std::list<Triangle>::iterator it;
-    #pragma omp parallel for schedule(dynamic) shared( nloop, ntris, calls, clref ) private(n,tris,it) 
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared( nloop, ntris, calls, clref ) private(n,tris,it) 
         for (n=0;n<Nmax;++n) { // PARALLEL OpenMP loop!
 #ifdef _OPENMP
             if ( n== 0 ) { // first iteration
@@ -236,5 +243,348 @@ void BatchDropCutter::dropCutter5() {
     return;
 }
 
+// a packet is a run of consecutive CL-points that all lie within one
+// cutter-diameter (in the xy-plane) from the first point of the packet.
+// raster and path input is spatially coherent, so consecutive points are nearby.
+std::vector<unsigned int> BatchDropCutter::build_packets(const std::vector<CLPoint>& pts, double d) const {
+    std::vector<unsigned int> packets;
+    unsigned int n = 0;
+    while ( n < pts.size() ) {
+        packets.push_back(n);
+        unsigned int first = n;
+        ++n;
+        while ( (n < pts.size()) && 
+                (n-first < packetSize) && 
+                (pts[n].xyDistance( pts[first] ) <= d ) ) {
+            ++n;
+        }
+    }
+    packets.push_back( pts.size() );
+    return packets;
+}
+
+// packet version of dropCutter5()
+// one kd-tree search with the union bounding-box of all cutter positions in the packet
+// returns the candidate triangles for the whole packet, and the cheap 
+// MillingCutter::overlaps() test selects the triangles for each CL-point.
+void BatchDropCutter::dropCutter6() {
+    std::cout << "dropCutterSTL6 " << clpoints->size() << 
+            " cl-points and " << surf->tris.size() << " triangles.\n";
+    packet_drop( *clpoints );
+    std::cout << "\n " << nCalls << " dropCutter() calls, ";
+    std::cout << nNodes << " kd-tree nodes visited.\n";
+}
+
+void BatchDropCutter::packet_drop(std::vector<CLPoint>& clref) {
+    boost::progress_display show_progress( clref.size() );
+    std::vector<unsigned int> packets = build_packets( clref, cutter->getDiameter() );
+    int calls=0;
+    unsigned long nodes=0;
+    std::list<Triangle>* tris;
+    int m;
+    int Npackets = packets.size()-1;
+    std::list<Triangle>::iterator it;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared( clref, packets ) private(m,tris,it) reduction(+:calls,nodes)
+        for (m=0;m<Npackets;++m) { // PARALLEL OpenMP loop over packets
+            Bbox bb;
+            for (unsigned int n=packets[m]; n<packets[m+1]; ++n) { // union of cutter bounding-boxes
+                Bbox cl_bb = KDTree<Triangle>::cutter_bbox( cutter, &clref[n] );
+                bb.addPoint( cl_bb.minpt );
+                bb.addPoint( cl_bb.maxpt );
+            }
+            unsigned long visits = 0;
+            tris = root->search( bb, visits );
+            nodes += visits;
+            for (unsigned int n=packets[m]; n<packets[m+1]; ++n) {
+                for( it=tris->begin(); it!=tris->end() ; ++it) { // loop over the packet triangles
+                    if ( cutter->overlaps(clref[n],*it) ) { // cutter overlap triangle? check
+                        if (clref[n].below(*it)) {
+                            cutter->dropCutter( clref[n],*it);
+                            ++calls;
+                        }
+                    }
+                }
+                ++show_progress;
+            }
+            delete( tris );
+        } // end OpenMP PARALLEL for
+    nCalls = calls;
+    nNodes = nodes;
+    return;
+}
+
+// multi-cutter version of packet_drop()
+// the packets and the kd-tree searches use the footprint of the largest cutter, which
+// contains the footprint of every smaller cutter. For each CL-point the cutters then
+// filter the shared candidate triangles with their own MillingCutter::overlaps() test.
+void BatchDropCutter::dropCutterMulti() {
+    std::cout << "dropCutterMulti " << clpoints->size() << " cl-points, " << cutters.size() << 
+            " cutters and " << surf->tris.size() << " triangles.\n";
+    cutterCLPoints.assign( cutters.size(), *clpoints );
+    if ( cutters.empty() )
+        return;
+    const MillingCutter* largest = cutters[0];
+    BOOST_FOREACH( const MillingCutter* c, cutters ) {
+        if ( c->getRadius() > largest->getRadius() )
+            largest = c;
+    }
+    boost::progress_display show_progress( clpoints->size() );
+    std::vector<unsigned int> packets = build_packets( *clpoints, largest->getDiameter() );
+    std::vector< std::vector<CLPoint> >& clref = cutterCLPoints;
+    const std::vector<const MillingCutter*>& cref = cutters;
+    int calls=0;
+    unsigned long nodes=0;
+    std::list<Triangle>* tris;
+    int m;
+    int Npackets = packets.size()-1;
+    int Ncutters = cutters.size();
+    std::list<Triangle>::iterator it;
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic) shared( clref, cref, packets, largest ) private(m,tris,it) reduction(+:calls,nodes)
+        for (m=0;m<Npackets;++m) { // PARALLEL OpenMP loop over packets
+            Bbox bb;
+            for (unsigned int n=packets[m]; n<packets[m+1]; ++n) { // union of largest-cutter bounding-boxes
+                Bbox cl_bb = KDTree<Triangle>::cutter_bbox( largest, &(*clpoints)[n] );
+                bb.addPoint( cl_bb.minpt );
+                bb.addPoint( cl_bb.maxpt );
+            }
+            unsigned long visits = 0;
+            tris = root->search( bb, visits );
+            nodes += visits;
+            for (unsigned int n=packets[m]; n<packets[m+1]; ++n) {
+                for (int k=0; k<Ncutters; ++k) { // every cutter against the same candidates
+                    CLPoint& cl = clref[k][n];
+                    for( it=tris->begin(); it!=tris->end() ; ++it) {
+                        if ( cref[k]->overlaps(cl,*it) ) {
+                            if (cl.below(*it)) {
+                                cref[k]->dropCutter(cl,*it);
+                                ++calls;
+                            }
+                        }
+                    }
+                }
+                ++show_progress;
+            }
+            delete( tris );
+        } // end OpenMP PARALLEL for
+    nCalls = calls;
+    nNodes = nodes;
+    std::cout << "\n " << nCalls << " dropCutter() calls, ";
+    std::cout << nNodes << " kd-tree nodes visited.\n";
+}
+
+// result-file record: cl.x, cl.y, cl.z, cc.x, cc.y, cc.z as double, followed by cc.type as int
+static const unsigned int CHECKPOINT_RECORD_SIZE = 6*sizeof(double) + sizeof(int);
+
+static void write_record(std::ostream& out, const CLPoint& cl) {
+    double v[6] = { cl.x, cl.y, cl.z, cl.cc->x, cl.cc->y, cl.cc->z };
+    int type = cl.cc->type;
+    out.write( (const char*)v, 6*sizeof(double) );
+    out.write( (const char*)&type, sizeof(int) );
+}
+
+static CLPoint read_record(std::istream& in) {
+    double v[6];
+    int type;
+    in.read( (char*)v, 6*sizeof(double) );
+    in.read( (char*)&type, sizeof(int) );
+    CCPoint cc( v[3], v[4], v[5], (CCType)type );
+    return CLPoint( v[0], v[1], v[2], cc );
+}
+
+// input-file record: cl.x, cl.y, cl.z as double
+static const unsigned int INPUT_RECORD_SIZE = 3*sizeof(double);
+
+// FNV-1a hash of n bytes, continuing from hash h
+static boost::uint64_t fnv1a(boost::uint64_t h, const char* bytes, size_t n) {
+    for (size_t m=0; m<n; ++m) {
+        h ^= (unsigned char)bytes[m];
+        h *= UINT64_C(1099511628211);
+    }
+    return h;
+}
+static const boost::uint64_t FNV_OFFSET = UINT64_C(14695981039346656037);
+
+// the checksum of the x, y, z doubles of the CL-points, the same as for an input-file of them
+static boost::uint64_t input_checksum(const std::vector<CLPoint>& pts) {
+    boost::uint64_t h = FNV_OFFSET;
+    BOOST_FOREACH( const CLPoint& p, pts ) {
+        double v[3] = { p.x, p.y, p.z };
+        h = fnv1a( h, (const char*)v, INPUT_RECORD_SIZE );
+    }
+    return h;
+}
+
+// the checksum of an input-file, read in blocks
+static boost::uint64_t input_checksum(std::istream& in) {
+    boost::uint64_t h = FNV_OFFSET;
+    std::vector<char> block( 1 << 16 );
+    in.seekg( 0 );
+    while ( in ) {
+        in.read( &block[0], block.size() );
+        h = fnv1a( h, &block[0], in.gcount() );
+    }
+    in.clear();
+    return h;
+}
+
+// write the data of a file, written and flushed by a C++ stream, to the disk.
+// a flushed stream has only handed its data to the operating system
+static bool sync_file(const std::string& name) {
+#ifdef _WIN32
+    int fd = _open( name.c_str(), _O_RDWR | _O_BINARY );
+    if ( fd < 0 )
+        return false;
+    bool ok = ( _commit(fd) == 0 );
+    _close(fd);
+#else
+    int fd = open( name.c_str(), O_RDWR );
+    if ( fd < 0 )
+        return false;
+    bool ok = ( fsync(fd) == 0 );
+    close(fd);
+#endif
+    return ok;
+}
+
+bool BatchDropCutter::runCheckpointed(const std::string& filename) {
+    return checkpointed_run( filename, clpoints->size(), NULL, "-", input_checksum( *clpoints ) );
+}
+
+bool BatchDropCutter::runCheckpointed(const std::string& input, const std::string& filename) {
+    std::ifstream in( input.c_str(), std::ios::binary | std::ios::ate );
+    if ( !in ) {
+        std::cout << "ERROR: BatchDropCutter::runCheckpointed() can't open " << input << "\n";
+        return false;
+    }
+    const std::streamoff bytes = in.tellg();
+    if ( bytes % INPUT_RECORD_SIZE != 0 ) {
+        std::cout << "ERROR: BatchDropCutter::runCheckpointed() " << input << " is not a file of x, y, z doubles.\n";
+        return false;
+    }
+    return checkpointed_run( filename, (size_t)(bytes / INPUT_RECORD_SIZE), &in, input, input_checksum( in ) );
+}
+
+// read count CL-points, starting at index first, from an input-file
+static bool read_input(std::istream& in, size_t first, size_t count, std::vector<CLPoint>& pts) {
+    std::vector<double> v( 3*count );
+    in.seekg( (std::streamoff)first * INPUT_RECORD_SIZE );
+    in.read( (char*)&v[0], count*INPUT_RECORD_SIZE );
+    pts.resize( count );
+    for (size_t n=0; n<count; ++n) {
+        pts[n].x = v[3*n];
+        pts[n].y = v[3*n+1];
+        pts[n].z = v[3*n+2];
+    }
+    return (bool)in;
+}
+
+// the manifest is a small text-file:
+//  OCL-CHECKPOINT <number of cl-points> <chunk-size> <record-size>
+//  input <size in bytes> <checksum> <input-file, or - for the CL-points of appendPoint()>
+//  done <chunk-number>
+//  done <chunk-number>
+//  ...
+// a chunk is listed only after its results are written to the disk, not only flushed,
+// so a crash at any point at most causes one chunk to be computed again.
+// a manifest is only resumed with the same input, compared by size and checksum.
+bool BatchDropCutter::checkpointed_run(const std::string& filename, size_t Npoints, std::istream* input,
+                                       const std::string& input_name, boost::uint64_t checksum) {
+    const std::string manifest_name = filename + ".manifest";
+    const size_t Nchunks = (Npoints + chunkSize - 1) / chunkSize;
+    std::set<size_t> done;
+    std::ifstream manifest_in( manifest_name.c_str() );
+    if ( manifest_in ) { // resume an earlier run
+        std::string tag, itag, iname;
+        size_t n=0, bytes=0;
+        unsigned int c=0, r=0;
+        boost::uint64_t sum=0;
+        manifest_in >> tag >> n >> c >> r >> itag >> bytes >> std::hex >> sum >> std::dec;
+        std::getline( manifest_in, iname );
+        if ( (tag != "OCL-CHECKPOINT") || (n != Npoints) || (c != chunkSize) || (r != CHECKPOINT_RECORD_SIZE) ||
+             (itag != "input") || (bytes != Npoints*INPUT_RECORD_SIZE) || (sum != checksum) ) {
+            std::cout << "ERROR: BatchDropCutter::runCheckpointed() " << manifest_name << " is from a different job";
+            if ( itag == "input" && iname.size() > 1 )
+                std::cout << ", with input" << iname;
+            std::cout << ".\n";
+            return false;
+        }
+        size_t k;
+        while ( manifest_in >> tag >> k ) {
+            if ( tag == "done" )
+                done.insert(k);
+        }
+        manifest_in.close();
+        std::cout << "BatchDropCutter::runCheckpointed() resuming, " << done.size() << " of " << Nchunks << " chunks done.\n";
+    } else { // a new run, write the manifest header and create an empty result-file
+        std::ofstream result_out( filename.c_str(), std::ios::binary | std::ios::trunc );
+        std::ofstream manifest_out( manifest_name.c_str() );
+        manifest_out << "OCL-CHECKPOINT " << Npoints << " " << chunkSize << " " << CHECKPOINT_RECORD_SIZE << "\n";
+        manifest_out << "input " << Npoints*INPUT_RECORD_SIZE << " " << std::hex << checksum << std::dec << " " << input_name << "\n";
+        manifest_out.flush();
+        if ( !manifest_out || !result_out ) {
+            std::cout << "ERROR: BatchDropCutter::runCheckpointed() can't create " << filename << "\n";
+            return false;
+        }
+    }
+    
+    std::fstream results( filename.c_str(), std::ios::binary | std::ios::in | std::ios::out );
+    std::ofstream manifest( manifest_name.c_str(), std::ios::app );
+    if ( !results || !manifest ) {
+        std::cout << "ERROR: BatchDropCutter::runCheckpointed() can't open " << filename << "\n";
+        return false;
+    }
+    std::cout << "dropCutterSTL6 checkpointed " << Npoints << " cl-points in " << Nchunks << " chunks.\n";
+    int calls = 0;
+    unsigned long nodes = 0;
+    for (size_t k=0; k<Nchunks; ++k) {
+        if ( done.count(k) )
+            continue;
+        size_t first = k*chunkSize;
+        size_t last = std::min( first+chunkSize, Npoints );
+        // the results of this chunk only live in memory until they are written
+        std::vector<CLPoint> chunk;
+        if ( !input ) {
+            chunk.assign( clpoints->begin()+first, clpoints->begin()+last );
+        } else if ( !read_input( *input, first, last-first, chunk ) ) {
+            std::cout << "ERROR: BatchDropCutter::runCheckpointed() read of the input CL-points failed.\n";
+            return false;
+        }
+        packet_drop( chunk );
+        calls += nCalls;
+        nodes += nNodes;
+        results.seekp( (std::streamoff)first * CHECKPOINT_RECORD_SIZE );
+        BOOST_FOREACH( const CLPoint& cl, chunk ) {
+            write_record( results, cl );
+        }
+        results.flush();
+        if ( !results || !sync_file( filename ) ) {
+            std::cout << "ERROR: BatchDropCutter::runCheckpointed() write to " << filename << " failed.\n";
+            return false;
+        }
+        manifest << "done " << k << std::endl; // std::endl flushes the manifest
+        if ( !manifest || !sync_file( manifest_name ) ) {
+            std::cout << "ERROR: BatchDropCutter::runCheckpointed() write to " << manifest_name << " failed.\n";
+            return false;
+        }
+    }
+    nCalls = calls;
+    nNodes = nodes;
+    std::cout << "\n " << nCalls << " dropCutter() calls, " << nNodes << " kd-tree nodes visited.\n";
+    return true;
+}
+
+std::vector<CLPoint> BatchDropCutter::readResults(const std::string& filename, size_t first, size_t count) {
+    std::vector<CLPoint> out;
+    std::ifstream in( filename.c_str(), std::ios::binary );
+    in.seekg( (std::streamoff)first * CHECKPOINT_RECORD_SIZE );
+    for (size_t n=0; n<count; ++n) {
+        CLPoint cl = read_record(in);
+        if ( !in )
+            break;
+        out.push_back(cl);
+    }
+    return out;
+}
+
 }// end namespace
 // end file batchdropcutter.cpp
@@ -22,9 +22,12 @@
 #define BDC_H
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include <boost/cstdint.hpp>
+
 #include "clpoint.h"
 #include "millingcutter.h"
 #include "kdtree.h"
@@ -53,13 +56,56 @@ class BatchDropCutter : public Operation {
         /// append to list of CL-points to evaluate
         void appendPoint(CLPoint& p);
         /// run drop-cutter on all clpoints
-        void run() {this->dropCutter5();};
+        void run() {this->dropCutter6();};
     // getters and setters
         /// return a vector of CLPoints, the result of this operation
         std::vector<CLPoint> getCLPoints() {return *clpoints;}
 		/// clears the vector of CLPoints
 		void clearCLPoints() {clpoints->clear();}
-        
+
+        /// \brief run drop-cutter in chunks, with a checkpoint after each chunk.
+        ///
+        /// the results of each finished chunk are written to the binary file filename,
+        /// and the chunk number is recorded in the text file filename.manifest.
+        /// when called again with the same filename, chunks already listed in the
+        /// manifest are skipped, so an interrupted job resumes where it stopped.
+        /// results are not kept in memory, use readResults() to read them back.
+        /// returns false if the files can't be used (I/O error, or a manifest from a different job,
+        /// i.e. other input CL-points, by size and checksum, or another chunk-size).
+        /// the input CL-points added with appendPoint() stay in memory, see the streaming version below.
+        bool runCheckpointed(const std::string& filename);
+        /// \brief as runCheckpointed(filename), with the input CL-points streamed from the file input.
+        ///
+        /// input is a binary file of x, y, z doubles, three per CL-point, e.g. written by numpy's tofile().
+        /// only one chunk of input CL-points is in memory at a time, and the CL-points
+        /// added with appendPoint() are not used. the input is read once more for its checksum.
+        bool runCheckpointed(const std::string& input, const std::string& filename);
+        /// set the number of CL-points between checkpoints of runCheckpointed().
+        /// throws std::invalid_argument, ValueError in Python, if n is zero
+        void setChunkSize(unsigned int n) {
+            if ( n == 0 )
+                throw std::invalid_argument("the chunk-size must be at least one CL-point");
+            chunkSize = n;
+        }
+        /// return the chunk-size of runCheckpointed()
+        unsigned int getChunkSize() const {return chunkSize;}
+        /// read count CL-points, starting at index first, from a result file written by runCheckpointed()
+        static std::vector<CLPoint> readResults(const std::string& filename, size_t first, size_t count);
+
+        /// add a cutter for runCutters()
+        void appendCutter(const MillingCutter* c) {cutters.push_back(c);}
+        /// remove all cutters added with appendCutter()
+        void clearCutters() {cutters.clear(); cutterCLPoints.clear();}
+        /// \brief run drop-cutter on all clpoints with every cutter added by appendCutter().
+        ///
+        /// the kd-tree is searched once with the footprint of the largest cutter, and
+        /// all cutters are dropped against this shared set of candidate triangles.
+        /// the input CL-points are not modified, getCutterCLPoints() returns the results.
+        void runCutters() {this->dropCutterMulti();}
+        /// return the CL-points computed by runCutters() for cutter number n.
+        /// throws std::out_of_range if there is no cutter n
+        std::vector<CLPoint> getCutterCLPoints(unsigned int n) const {return cutterCLPoints.at(n);}
+
     protected:
         /// unoptimized drop-cutter,  tests against all triangles of surface
         void dropCutter1();
@@ -71,9 +117,28 @@ class BatchDropCutter : public Operation {
         void dropCutter4();
         /// version 5 of the algorithm
         void dropCutter5();
+        /// packets of nearby CL-points share one kd-tree search
+        void dropCutter6();
+        /// the drop-cutter loop of dropCutter6(), run on the given CL-points
+        void packet_drop(std::vector<CLPoint>& pts);
+        /// group consecutive CL-points within distance d of each other into packets of at most packetSize points.
+        /// returns the index of the first CL-point of each packet, followed by pts.size()
+        std::vector<unsigned int> build_packets(const std::vector<CLPoint>& pts, double d) const;
+        /// packet drop-cutter with several cutters sharing each kd-tree search
+        void dropCutterMulti();
+        /// the chunk loop of runCheckpointed(), on Npoints CL-points read from input,
+        /// or taken from clpoints if input is NULL. input_name and checksum identify the input in the manifest
+        bool checkpointed_run(const std::string& filename, size_t Npoints, std::istream* input,
+                              const std::string& input_name, boost::uint64_t checksum);
     // DATA
         /// pointer to list of CL-points on which to run drop-cutter.
         std::vector<CLPoint>* clpoints;
+        /// number of CL-points between checkpoints in runCheckpointed()
+        unsigned int chunkSize;
+        /// cutters for runCutters()
+        std::vector<const MillingCutter*> cutters;
+        /// results of runCutters(), one vector of CL-points for each cutter
+        std::vector< std::vector<CLPoint> > cutterCLPoints;
 
 };
 
@@ -21,10 +21,13 @@
 #ifndef BDC_PY_H
 #define BDC_PY_H
 
+#include <sstream>
+
 #include <boost/python.hpp> 
 #include <boost/foreach.hpp> 
 
 #include "batchdropcutter.h"
+#include "array_py.h"
 //#include "kdtree3.h" 
 
 namespace ocl
@@ -34,6 +37,27 @@ namespace ocl
 class BatchDropCutter_py : public BatchDropCutter {
     public:
         BatchDropCutter_py() : BatchDropCutter() {};
+        /// append the rows of an N-by-3 array as CL-points.
+        /// raise ValueError, and append none of them, if a coordinate is NaN or infinite.
+        /// every CLPoint allocates its CCPoint, which limits how fast points are added
+        void appendPoints(const boost::python::object& a) {
+            ArrayView pts(a, 2, 3);
+            for (unsigned int n=0; n<pts.size(); ++n) {
+                if ( !is_finite( pts.point(n) ) ) {
+                    std::ostringstream o;
+                    o << "point " << n << " is not finite: " << pts(n,0) << " " << pts(n,1) << " " << pts(n,2);
+                    value_error( o.str() );
+                }
+            }
+            clpoints->reserve( clpoints->size() + pts.size() );
+            CLPoint p;
+            for (unsigned int n=0; n<pts.size(); ++n) {
+                p.x = pts(n,0);
+                p.y = pts(n,1);
+                p.z = pts(n,2);
+                clpoints->push_back(p);
+            }
+        }
         /// return CL-points to Python
         boost::python::list getCLPoints_py() {
             boost::python::list plist;
@@ -42,6 +66,25 @@ class BatchDropCutter_py : public BatchDropCutter {
             }
             return plist;
         };
+        /// return the CL-points to Python as an N-by-4 Array of x, y, z and cc-type
+        boost::python::object getCLPointArray() const {
+            return clpoint_array( *clpoints );
+        }
+        /// return CL-points of cutter n, computed by runCutters(), to Python.
+        /// raise IndexError if there is no cutter n, or runCutters() has not been called
+        boost::python::list getCutterCLPoints_py(unsigned int n) {
+            if ( n >= cutterCLPoints.size() ) {
+                std::ostringstream o;
+                o << "no CL-points for cutter " << n << ", runCutters() has computed " << cutterCLPoints.size();
+                PyErr_SetString( PyExc_IndexError, o.str().c_str() );
+                boost::python::throw_error_already_set();
+            }
+            boost::python::list plist;
+            BOOST_FOREACH(CLPoint p, cutterCLPoints[n]) {
+                plist.append(p);
+            }
+            return plist;
+        };
         /// return triangles under cutter to Python. Not for CAM-algorithms, 
         /// more for visualization and demonstration.
         boost::python::list getTrianglesUnderCutter(CLPoint& cl, MillingCutter& cutter) {
@@ -54,6 +97,14 @@ class BatchDropCutter_py : public BatchDropCutter {
             delete triangles_under_cutter;
             return trilist;
         };
+        /// return CL-points from a runCheckpointed() result-file to Python
+        static boost::python::list readResults_py(const std::string& filename, size_t first, size_t count) {
+            boost::python::list plist;
+            BOOST_FOREACH(CLPoint p, readResults(filename, first, count)) {
+                plist.append(p);
+            }
+            return plist;
+        };
 };
 
 } // end namespace
@@ -22,6 +22,7 @@
 
 #include "millingcutter.h"
 #include "clpoint.h"
+#include "lineclfilter.h"
 #include "pathdropcutter.h"
 
 namespace ocl
@@ -37,6 +38,10 @@ PathDropCutter::PathDropCutter() {
     subOp.clear();
     subOp.push_back( new BatchDropCutter() );  // we delegate to BatchDropCutter, who does the heavy lifting
     sampling = 0.1;
+    chunkSize = 100000;
+    filterTolerance = 0.0;
+    sink = NULL;
+    nChunk = 0;
 }
 
 PathDropCutter::~PathDropCutter() {
@@ -56,6 +61,7 @@ void PathDropCutter::run() {
 
 void PathDropCutter::uniform_sampling_run() {
     clpoints.clear();
+    sink = NULL; // not streaming, also if an earlier streamRun() was interrupted
     BOOST_FOREACH( const Span* span, path->span_list ) { // loop through the spans calling run() on each
         this->sample_span(span); // append points to bdc
     }
@@ -63,19 +69,69 @@ void PathDropCutter::uniform_sampling_run() {
     clpoints = subOp[0]->getCLPoints();
 }
 
-// this samples the Span and pushes the corresponding sampled points to bdc
+// this samples the Span and pushes the corresponding sampled points to bdc.
+// during streamRun(), the batch is run and written to the sink every chunkSize points
 void PathDropCutter::sample_span(const Span* span) {
     assert( sampling > 0.0 );
     unsigned int num_steps = (unsigned int)(span->length2d() / sampling + 1);
     for(unsigned int i = 0; i<=num_steps; i++) {
         double fraction = (double)i / num_steps;
         Point ptmp = span->getPoint(fraction);
-        CLPoint* p = new CLPoint(ptmp.x, ptmp.y, ptmp.z);
-        p->z = minimumZ;
-        subOp[0]->appendPoint( *p );
-        delete p;
+        CLPoint p(ptmp.x, ptmp.y, minimumZ);
+        subOp[0]->appendPoint( p );
+        if ( sink && ++nChunk == chunkSize )
+            stream_chunk();
     }    
 }
 
+// the same sampling as uniform_sampling_run(), but every chunkSize points 
+// the batch in subOp[0] is run, written to sink, and cleared.
+void PathDropCutter::streamRun(CLPointSink& s) {
+    clpoints.clear();
+    subOp[0]->clearCLPoints();
+    sink = &s;
+    carry.clear();
+    nChunk = 0;
+    BOOST_FOREACH( const Span* span, path->span_list ) {
+        this->sample_span(span);
+    }
+    if ( nChunk > 0 )
+        stream_chunk();
+    if ( !carry.empty() )
+        sink->write( carry );
+    sink->done();
+    sink = NULL;
+    carry.clear();
+}
+
+void PathDropCutter::stream_chunk() {
+    nChunk = 0;
+    subOp[0]->run();
+    std::vector<CLPoint> chunk = subOp[0]->getCLPoints();
+    subOp[0]->clearCLPoints();
+    if ( filterTolerance <= 0.0 ) {
+        sink->write( chunk );
+        return;
+    }
+    // filter the held-back point together with this chunk. The last filtered point
+    // is held back again, since the next chunk may continue the same line.
+    LineCLFilter f;
+    f.setTolerance( filterTolerance );
+    BOOST_FOREACH( const CLPoint& p, carry ) {
+        f.addCLPoint( p );
+    }
+    BOOST_FOREACH( const CLPoint& p, chunk ) {
+        f.addCLPoint( p );
+    }
+    chunk.clear();
+    f.run();
+    carry.clear();
+    carry.push_back( f.clpoints.back() );
+    f.clpoints.pop_back();
+    chunk.assign( f.clpoints.begin(), f.clpoints.end() );
+    if ( !chunk.empty() )
+        sink->write( chunk );
+}
+
 } // end namespace
 // end file pathdropcutter.cpp
@@ -22,6 +22,7 @@
 #define PATHDROPCUTTER_H
 
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <list>
 
@@ -37,6 +38,17 @@ class STLSurf;
 class Triangle;
 //class KDNode;
 
+/// \brief receives the CL-points of PathDropCutter::streamRun() chunk by chunk, in path-order
+class CLPointSink {
+    public:
+        CLPointSink() {}
+        virtual ~CLPointSink() {}
+        /// called for each consecutive chunk of CL-points
+        virtual void write(const std::vector<CLPoint>& chunk) = 0;
+        /// called once after the last chunk has been written
+        virtual void done() {}
+};
+
 ///
 /// \brief path drop cutter finish Path generation
 class PathDropCutter : public Operation {
@@ -56,6 +68,26 @@ class PathDropCutter : public Operation {
         }
         /// run drop-cutter on the whole Path
         virtual void run();
+        /// run drop-cutter on the whole Path in chunks of chunkSize CL-points.
+        /// the CL-points are not stored, each finished chunk is written to sink,
+        /// so memory use is bounded by the chunk-size and not by the length of the Path.
+        void streamRun(CLPointSink& sink);
+        /// set the number of CL-points in each chunk of streamRun().
+        /// throws std::invalid_argument, ValueError in Python, if n is zero
+        void setChunkSize(unsigned int n) {
+            if ( n == 0 )
+                throw std::invalid_argument("the chunk-size must be at least one CL-point");
+            chunkSize = n;
+        }
+        /// return the chunk-size of streamRun()
+        unsigned int getChunkSize() const {
+            return chunkSize;
+        }
+        /// filter the output of streamRun() with a LineCLFilter of tolerance tol. 
+        /// tol <= 0 disables the filter (the default).
+        void setFilterTolerance(double tol) {
+            filterTolerance = tol;
+        }
         
     protected:
         /// the path to follow
@@ -64,11 +96,24 @@ class PathDropCutter : public Operation {
         double minimumZ;
         /// list of CL-points
         std::vector<CLPoint> clpoints;
+        /// number of CL-points in each chunk of streamRun()
+        unsigned int chunkSize;
+        /// LineCLFilter tolerance for streamRun()
+        double filterTolerance;
+        /// the sink of streamRun(), NULL otherwise
+        CLPointSink* sink;
+        /// at most one CL-point, held back by the filter of streamRun()
+        std::vector<CLPoint> carry;
+        /// the number of CL-points of the current chunk of streamRun()
+        unsigned int nChunk;
     private:
         /// the algorithm
         void uniform_sampling_run();
         /// sample the span unfirormly with tolerance sampling
         void sample_span(const Span* span);
+        /// run drop-cutter on the current chunk in subOp[0], filter it, and write it to sink.
+        /// the last CL-point of a filtered chunk is kept in carry, and written with the next chunk.
+        void stream_chunk();
 };
 
 } // end namespace
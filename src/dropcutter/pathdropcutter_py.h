@@ -29,6 +29,24 @@
 namespace ocl
 {
 
+/// CLPointSink which calls a python callable with a list of CL-points for each chunk
+class CLPointSink_py : public CLPointSink {
+    public:
+        /// create sink for python callable cb
+        CLPointSink_py(boost::python::object cb) : callback(cb) {}
+        /// convert the chunk to a python list and call the callback
+        void write(const std::vector<CLPoint>& chunk) {
+            boost::python::list plist;
+            BOOST_FOREACH(CLPoint p, chunk) {
+                plist.append(p);
+            }
+            callback(plist);
+        }
+    protected:
+        /// the python callable
+        boost::python::object callback;
+};
+
 /// Python wrapper for PathDropCutter
 class PathDropCutter_py : public PathDropCutter {
     public:
@@ -41,6 +59,12 @@ class PathDropCutter_py : public PathDropCutter {
             }
             return plist;
         };
+        /// run streamRun() with a python callable, which is called with a 
+        /// list of CL-points for each chunk, in path-order.
+        void streamRun_py(boost::python::object callback) {
+            CLPointSink_py sink(callback);
+            streamRun(sink);
+        }
 };
 
 } // end namespace
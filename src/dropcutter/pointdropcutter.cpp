@@ -59,9 +59,9 @@ void PointDropCutter::run(CLPoint& clp) {
     //std::cout  << clp << " nCalls = " << nCalls <<"\n ";
 }
 
-// use OpenMP to share work between threads
+// this may be called concurrently from many threads, e.g. by AdaptivePathDropCutter.
+// the kd-tree is only read, and nCalls is written atomically.
 void PointDropCutter::pointDropCutter1(CLPoint& clp) {
-    nCalls = 0;
     int calls=0;
     std::list<Triangle>* tris;
     //tris=new std::list<Triangle>();
@@ -76,6 +76,7 @@ void PointDropCutter::pointDropCutter1(CLPoint& clp) {
         }
     }
     delete( tris );
+    #pragma omp atomic write
     nCalls = calls;
     return;
 }
@@ -21,11 +21,14 @@
 #define PATH_PY_H
 
 #include <list>
+#include <sstream>
+#include <string>
 
 #include <boost/python.hpp>
 #include <boost/foreach.hpp>
 
 #include "path.h"
+#include "array_py.h"
 
 
 
@@ -38,6 +41,27 @@ class Path_py : public Path {
         Path_py() : Path () {};
         /// copy constructor
         Path_py(const Path &p) : Path(p) {};
+        /// append the lines of a polyline, given as an N-by-3 array of its points.
+        /// raise ValueError, and append none of them, if a point is NaN or infinite,
+        /// or repeats the point before it, which would give a line of zero length.
+        /// every segment is a LineSpan allocated by Path::append(), which limits how fast lines are added
+        void appendPolyline(const boost::python::object& a) {
+            ArrayView pts(a, 2, 3);
+            for (unsigned int n=0; n<pts.size(); ++n) {
+                std::string err;
+                if ( !is_finite( pts.point(n) ) )
+                    err = "is not finite";
+                else if ( n > 0 && pts.point(n) == pts.point(n-1) )
+                    err = "repeats the point before it";
+                if ( !err.empty() ) {
+                    std::ostringstream o;
+                    o << "point " << n << " " << err << ": " << pts.point(n);
+                    value_error( o.str() );
+                }
+            }
+            for (unsigned int n=1; n<pts.size(); ++n)
+                append( Line( pts.point(n-1), pts.point(n) ) );
+        }
         
         /// return the span-list to python
         boost::python::list getSpans() {
@@ -0,0 +1,41 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "slicedtriangle.h"
+
+namespace ocl
+{
+
+// the same quantities that MillingCutter::vertexPush() and
+// MillingCutter::generalFacetPush() compute from a Triangle
+SlicedTriangle::SlicedTriangle(const Triangle& t, double zh) : Triangle(t) {
+    sliced = t.zslice_verts(s1, s2, zh);
+    normal = t.upNormal();
+    horizontal = normal.zParallel();
+    if ( !horizontal ) {
+        normal.normalize();
+        xy_normal = normal;
+        xy_normal.z = 0;
+        xy_normal.xyNormalize();
+    }
+}
+
+} // end namespace
+// end file slicedtriangle.cpp
@@ -0,0 +1,57 @@
+/*  $Id$
+ *
+ *  Copyright 2010-2011 Anders Wallin (anders.e.e.wallin "at" gmail.com)
+ *
+ *  This file is part of OpenCAMlib.
+ *
+ *  OpenCAMlib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  OpenCAMlib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with OpenCAMlib.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SLICED_TRIANGLE_H
+#define SLICED_TRIANGLE_H
+
+#include "point.h"
+#include "triangle.h"
+
+namespace ocl
+{
+
+/// \brief a Triangle with the push-cutter data for one z-height
+///
+/// the data depends only on the triangle and the z-height, so it is
+/// computed once and used by all X- and Y-fibers at this height.
+class SlicedTriangle : public Triangle {
+    public:
+        SlicedTriangle() {}
+        /// copy t and compute the push-cutter data for fibers at z-height zh
+        SlicedTriangle(const Triangle& t, double zh);
+
+        /// true if the plane z=zh slices the triangle
+        bool sliced;
+        /// the end-points of the slice, see Triangle::zslice_verts()
+        Point s1;
+        /// the end-points of the slice, see Triangle::zslice_verts()
+        Point s2;
+        /// true if the triangle is horizontal, facetPush() can't push against it
+        bool horizontal;
+        /// the normalized upNormal()
+        Point normal;
+        /// the normalized xy-projection of normal
+        Point xy_normal;
+};
+
+} // end namespace
+
+#endif
+// end file slicedtriangle.h
@@ -40,21 +40,20 @@ namespace ocl
 
     using namespace std;
 
-    static std::string str_for_Ttc;
-
     /// consider renaming?
-    const char* Ttc(const wchar_t* str)
+    /// the string is returned by value, so files can be read concurrently on separate threads
+    std::string Ttc(const wchar_t* str)
     {
         // convert a wchar_t* string into a char* string
-        str_for_Ttc.clear();
+        std::string out;
         while (*str)
-            str_for_Ttc.push_back((char) *str++);
-        return str_for_Ttc.c_str();
+            out.push_back((char) *str++);
+        return out;
     }
 
     void STLReader::read_from_file(const wchar_t* filepath, STLSurf& surface) {
         // read the stl file
-        std::ifstream ifs(Ttc(filepath), ios::binary);
+        std::ifstream ifs(Ttc(filepath).c_str(), ios::binary);
         if(!ifs)return;
 
         char solid_string[6] = "aaaaa";
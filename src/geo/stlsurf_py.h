@@ -20,10 +20,14 @@
 #ifndef STLSURF_PY_H
 #define STLSURF_PY_H
 
+#include <list>
+#include <sstream>
+
 #include <boost/python.hpp>
 #include <boost/foreach.hpp>
 
 #include "stlsurf.h"
+#include "array_py.h"
 
 namespace ocl
 {
@@ -33,6 +37,43 @@ class STLSurf_py : public STLSurf {
     public:
         /// default constructor
         STLSurf_py() : STLSurf() {};
+        /// add triangles from an N-by-3-by-3 array of their vertices.
+        /// raise ValueError, and add none of them, if a vertex is not finite or a triangle has no area.
+        /// each Triangle is a list-node of about 230 bytes with its own normal and bounding-box,
+        /// so a large mesh is limited by allocating that memory, not by reading the array
+        void addTriangles(const boost::python::object& a) {
+            ArrayView corners(a, 3, 3, 3);
+            std::list<Triangle> added;
+            for (unsigned int n=0; n<corners.size(); ++n)
+                added.push_back( checked_triangle( corners.point(n,0), corners.point(n,1), corners.point(n,2), n ) );
+            add( added );
+        }
+        /// add the triangles of a mesh, from an N-by-3 array of vertices and an M-by-3
+        /// array of the vertex indices of each triangle. raise ValueError, and add none of them,
+        /// if an index is out of range, a vertex of a triangle is not finite, or a triangle has no area,
+        /// e.g. with a repeated index
+        void addMesh(const boost::python::object& v, const boost::python::object& f) {
+            ArrayView vertices(v, 2, 3);
+            ArrayView faces(f, 2, 3);
+            if ( !faces.integer() )
+                value_error("the faces must be an array of integer vertex indices");
+            std::vector<Point> pts( vertices.size() );
+            for (unsigned int n=0; n<pts.size(); ++n)
+                pts[n] = vertices.point(n);
+            std::list<Triangle> added;
+            for (unsigned int n=0; n<faces.size(); ++n) {
+                for (unsigned int m=0; m<3; ++m) {
+                    if ( faces(n,m) < 0 || faces(n,m) >= pts.size() ) {
+                        std::ostringstream o;
+                        o << "a vertex index of face " << n << " is out of range";
+                        value_error( o.str() );
+                    }
+                }
+                added.push_back( checked_triangle( pts[ (unsigned int)faces(n,0) ], pts[ (unsigned int)faces(n,1) ],
+                                                   pts[ (unsigned int)faces(n,2) ], n ) );
+            }
+            add( added );
+        }
         /// return list of all triangles to python
         boost::python::list getTriangles() const {
             boost::python::list tlist;
@@ -60,6 +101,29 @@ class STLSurf_py : public STLSurf {
             o << *this;
             return o.str();
         };
+    protected:
+        /// the triangle p1, p2, p3 in row n of an array. raise ValueError if a vertex is NaN
+        /// or infinite, or if it has no area, which addTriangle() does not allow
+        static Triangle checked_triangle(const Point& p1, const Point& p2, const Point& p3, unsigned int n) {
+            std::string err;
+            if ( !is_finite(p1) || !is_finite(p2) || !is_finite(p3) )
+                err = "is not finite";
+            else if ( (p2-p1).cross(p3-p1).norm() == 0.0 )
+                err = "has no area";
+            if ( !err.empty() ) {
+                std::ostringstream o;
+                o << "triangle " << n << " " << err << ": " << p1 << " " << p2 << " " << p3;
+                value_error( o.str() );
+            }
+            return Triangle(p1, p2, p3);
+        }
+        /// move the triangles to the end of tris, and grow the bounding-box
+        void add(std::list<Triangle>& added) {
+            BOOST_FOREACH( const Triangle& t, added ) {
+                bb.addTriangle(t);
+            }
+            tris.splice( tris.end(), added );
+        }
 };
 
 } // end namespace
@@ -45,12 +45,13 @@ Triangle::Triangle(Point p1, Point p2, Point p3) {
     calcBB();
 }
 
+// the normal and bounding-box are copied, not computed again
 Triangle::Triangle(const Triangle &t) {
     p[0]=t.p[0];
     p[1]=t.p[1];
     p[2]=t.p[2];
-    calcNormal();
-    calcBB();
+    n=t.n;
+    bb=t.bb;
 }
  
 
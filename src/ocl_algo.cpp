@@ -26,15 +26,19 @@
 //#include "weave_py.h"           
 #include "waterline_py.h"      
 #include "adaptivewaterline_py.h"  
+#include "multilevelwaterline_py.h"  
+#include "loopsequencer_py.h"
 #include "lineclfilter_py.h"    
+#include "arcclfilter_py.h"
 #include "numeric.h"
 
-#include "zigzag.h"
+#include "zigzag_py.h"
 #ifndef WIN32
-#include "clsurface.h"
+#include "clsurface_py.h"
 #endif
 
 #include "tsp.h" // fixme: contains python
+#include "tsplocal_py.h"
 
 /*
  *  Python wrapping of octree and related classes
@@ -49,14 +53,19 @@ void export_algo() {
     bp::def("epsF", epsF);
     bp::def("epsD", epsD);
     bp::def("revision", revision); // returns OCL revision string to python
-    bp::class_<ZigZag>("ZigZag")
-        .def("run", &ZigZag::run)
-        .def("setDirection", &ZigZag::setDirection)
-        .def("setOrigin", &ZigZag::setOrigin)
-        .def("setStepOver", &ZigZag::setStepOver)
-        .def("addPoint", &ZigZag::addPoint)
-        .def("getOutput", &ZigZag::getOutput)
-        .def("__str__", &ZigZag::str)
+    bp::class_<ZigZag>("ZigZag_base")
+    ;
+    bp::class_<ZigZag_py, bp::bases<ZigZag> >("ZigZag")
+        .def("run", &ZigZag_py::run)
+        .def("setDirection", &ZigZag_py::setDirection)
+        .def("setOrigin", &ZigZag_py::setOrigin)
+        .def("setStepOver", &ZigZag_py::setStepOver)
+        .def("setThreads", &ZigZag_py::setThreads)
+        .def("addPoint", &ZigZag_py::addPoint)
+        .def("addPolygon", &ZigZag_py::addPolygon_py)
+        .def("getOutput", &ZigZag_py::getOutput)
+        .def("getOutputArrays", &ZigZag_py::getOutputArrays)
+        .def("__str__", &ZigZag_py::str)
     ;
 
     bp::class_<BatchPushCutter>("BatchPushCutter_base")
@@ -67,9 +76,11 @@ void export_algo() {
         .def("setCutter", &BatchPushCutter_py::setCutter)
         .def("setThreads", &BatchPushCutter_py::setThreads)
         .def("appendFiber", &BatchPushCutter_py::appendFiber)
+        .def("appendFibers", &BatchPushCutter_py::appendFibers)
         .def("getOverlapTriangles", &BatchPushCutter_py::getOverlapTriangles)
         .def("getCLPoints", &BatchPushCutter_py::getCLPoints)
         .def("getFibers", &BatchPushCutter_py::getFibers_py)
+        .def("getFiberArrays", &BatchPushCutter_py::getFiberArrays)
         .def("getCalls", &BatchPushCutter_py::getCalls)
         .def("setThreads", &BatchPushCutter_py::setThreads)
         .def("getThreads", &BatchPushCutter_py::getThreads)
@@ -77,6 +88,11 @@ void export_algo() {
         .def("getBucketSize", &BatchPushCutter_py::getBucketSize)
         .def("setXDirection", &BatchPushCutter_py::setXDirection)
         .def("setYDirection", &BatchPushCutter_py::setYDirection)
+        .def("getNodes", &BatchPushCutter_py::getNodes)
+        .def("setPacketSize", &BatchPushCutter_py::setPacketSize)
+        .def("getPacketSize", &BatchPushCutter_py::getPacketSize)
+        .def("setSegmentLength", &BatchPushCutter_py::setSegmentLength)
+        .def("getSegmentLength", &BatchPushCutter_py::getSegmentLength)
     ;
     bp::class_<Interval>("Interval")
         .def(bp::init<double, double>())
@@ -110,10 +126,15 @@ void export_algo() {
         .def("setSampling", &Waterline_py::setSampling)
         .def("run", &Waterline_py::run)
         .def("getLoops", &Waterline_py::py_getLoops)
+        .def("getLoopArrays", &Waterline_py::getLoopArrays)
         .def("setThreads", &Waterline_py::setThreads)
         .def("getThreads", &Waterline_py::getThreads)
         .def("getXFibers", &Waterline_py::py_getXFibers)
         .def("getYFibers", &Waterline_py::py_getYFibers)
+        .def("setPacketSize", &Waterline_py::setPacketSize)
+        .def("setSegmentLength", &Waterline_py::setSegmentLength)
+        .def("setContourTracing", &Waterline_py::setContourTracing)
+        .def("setWeaveStrips", &Waterline_py::setWeaveStrips)
         
     ;
     bp::class_<AdaptiveWaterline>("AdaptiveWaterline_base")
@@ -126,10 +147,51 @@ void export_algo() {
         .def("setMinSampling", &AdaptiveWaterline_py::setMinSampling)
         .def("run", &AdaptiveWaterline_py::run)
         .def("getLoops", &AdaptiveWaterline_py::py_getLoops)
+        .def("getLoopArrays", &AdaptiveWaterline_py::getLoopArrays)
         .def("setThreads", &AdaptiveWaterline_py::setThreads)
         .def("getThreads", &AdaptiveWaterline_py::getThreads)
         .def("getXFibers", &AdaptiveWaterline_py::getXFibers)
         .def("getYFibers", &AdaptiveWaterline_py::getYFibers)
+        .def("setContourTracing", &AdaptiveWaterline_py::setContourTracing)
+        .def("setWeaveStrips", &AdaptiveWaterline_py::setWeaveStrips)
+    ;
+    bp::class_<MultiLevelWaterline>("MultiLevelWaterline_base")
+    ;
+    bp::class_<MultiLevelWaterline_py, bp::bases<MultiLevelWaterline> >("MultiLevelWaterline")
+        .def("setCutter", &MultiLevelWaterline_py::setCutter)
+        .def("setSTL", &MultiLevelWaterline_py::setSTL)
+        .def("addLevel", &MultiLevelWaterline_py::addLevel)
+        .def("clearLevels", &MultiLevelWaterline_py::clearLevels)
+        .def("getLevels", &MultiLevelWaterline_py::getLevels)
+        .def("setSampling", &MultiLevelWaterline_py::setSampling)
+        .def("run", &MultiLevelWaterline_py::run)
+        .def("getLoops", &MultiLevelWaterline_py::py_getLoops)
+        .def("getLoopArrays", &MultiLevelWaterline_py::getLoopArrays)
+        .def("setThreads", &MultiLevelWaterline_py::setThreads)
+        .def("getThreads", &MultiLevelWaterline_py::getThreads)
+        .def("setPacketSize", &MultiLevelWaterline_py::setPacketSize)
+        .def("setSegmentLength", &MultiLevelWaterline_py::setSegmentLength)
+        .def("setContourTracing", &MultiLevelWaterline_py::setContourTracing)
+        .def("setWeaveStrips", &MultiLevelWaterline_py::setWeaveStrips)
+    ;
+    bp::class_<LoopEntry>("LoopEntry")
+        .def_readonly("level", &LoopEntry::level)
+        .def_readonly("loop", &LoopEntry::loop)
+        .def_readonly("entry", &LoopEntry::entry)
+    ;
+    bp::class_<LoopSequencer>("LoopSequencer_base")
+    ;
+    bp::class_<LoopSequencer_py, bp::bases<LoopSequencer> >("LoopSequencer")
+        .def("addLevel", &LoopSequencer_py::addLevel_py)
+        .def("addWaterline", &LoopSequencer_py::addWaterline)
+        .def("addLevels", &LoopSequencer_py::addLevels)
+        .def("setStart", &LoopSequencer_py::setStart)
+        .def("setIslandOrder", &LoopSequencer_py::setIslandOrder)
+        .def("run", &LoopSequencer_py::run)
+        .def("getSequence", &LoopSequencer_py::getSequence_py)
+        .def("getLoops", &LoopSequencer_py::getLoops_py)
+        .def("getTravel", &LoopSequencer_py::getTravel)
+        .def("clear", &LoopSequencer_py::clear)
     ;
     /*
     bp::class_<Weave>("Weave_base")
@@ -156,17 +218,46 @@ void export_algo() {
         .def("run",         &LineCLFilter_py::run)
         .def("getCLPoints", &LineCLFilter_py::getCLPoints)
     ;
+    bp::enum_<ArcPlane>("ArcPlane")
+        .value("XY", XY_PLANE)
+        .value("XZ", XZ_PLANE)
+        .value("YZ", YZ_PLANE)
+    ;
+    bp::class_<CLMove>("CLMove")
+        .def_readonly("arc", &CLMove::arc)
+        .def_readonly("end", &CLMove::end)
+        .def_readonly("center", &CLMove::center)
+        .def_readonly("plane", &CLMove::plane)
+        .def_readonly("ccw", &CLMove::ccw)
+    ;
+    bp::class_<ArcCLFilter>("ArcCLFilter_base")
+    ;
+    bp::class_<ArcCLFilter_py, bp::bases<ArcCLFilter> >("ArcCLFilter")
+        .def("setTolerance", &ArcCLFilter_py::setTolerance)
+        .def("setArcs", &ArcCLFilter_py::setArcs)
+        .def("setMaxRadius", &ArcCLFilter_py::setMaxRadius)
+        .def("setThreads", &ArcCLFilter_py::setThreads)
+        .def("addCLPoints", &ArcCLFilter_py::addCLPoints_py)
+        .def("endPath", &ArcCLFilter_py::endPath)
+        .def("getMoves", &ArcCLFilter_py::getMoves)
+        .def("filterPaths", &ArcCLFilter_py::filterPaths_py)
+    ;
 #ifndef WIN32
-    bp::class_< clsurf::CutterLocationSurface >("CutterLocationSurface")  
-        .def(bp::init<double>())
-        .def("run", &clsurf::CutterLocationSurface::run)
-        .def("setMinSampling", &clsurf::CutterLocationSurface::setMinSampling)
-        .def("setSampling", &clsurf::CutterLocationSurface::setSampling)
-        .def("setSTL", &clsurf::CutterLocationSurface::setSTL)
-        .def("setCutter", &clsurf::CutterLocationSurface::setCutter)
-        .def("getVertices", &clsurf::CutterLocationSurface::getVertices)
-        .def("getEdges", &clsurf::CutterLocationSurface::getEdges)
-        .def("__str__", &clsurf::CutterLocationSurface::str)
+    bp::class_< clsurf::CutterLocationSurface >("CutterLocationSurface_base")
+    ;
+    bp::class_< clsurf::CutterLocationSurface_py, bp::bases<clsurf::CutterLocationSurface> >("CutterLocationSurface")
+        .def("run", &clsurf::CutterLocationSurface_py::run)
+        .def("setMinSampling", &clsurf::CutterLocationSurface_py::setMinSampling)
+        .def("setSampling", &clsurf::CutterLocationSurface_py::setSampling)
+        .def("setCosLimit", &clsurf::CutterLocationSurface_py::setCosLimit)
+        .def("setSTL", &clsurf::CutterLocationSurface_py::setSTL)
+        .def("setCutter", &clsurf::CutterLocationSurface_py::setCutter)
+        .def("setThreads", &clsurf::CutterLocationSurface_py::setThreads)
+        .def("getVertices", &clsurf::CutterLocationSurface_py::getVertices)
+        .def("getNormals", &clsurf::CutterLocationSurface_py::getNormals_py)
+        .def("getTriangles", &clsurf::CutterLocationSurface_py::getTriangles_py)
+        .def("getEdges", &clsurf::CutterLocationSurface_py::getEdges)
+        .def("__str__", &clsurf::CutterLocationSurface_py::str)
     ;
     
     bp::class_< tsp::TSPSolver >("TSPSolver")  
@@ -177,5 +268,14 @@ void export_algo() {
         .def("reset", &tsp::TSPSolver::reset)
     ;
 #endif
+    bp::class_< tsp::LocalTSPSolver_py >("LocalTSPSolver")
+        .def("addPoint", &tsp::LocalTSPSolver_py::addPoint)
+        .def("setTimeLimit", &tsp::LocalTSPSolver_py::setTimeLimit)
+        .def("setThreads", &tsp::LocalTSPSolver_py::setThreads)
+        .def("run", &tsp::LocalTSPSolver_py::run)
+        .def("getOutput", &tsp::LocalTSPSolver_py::getOutput)
+        .def("getLength", &tsp::LocalTSPSolver_py::getLength)
+        .def("reset", &tsp::LocalTSPSolver_py::reset)
+    ;
 }
 
@@ -46,7 +46,7 @@ void export_cutters() {
         .def("facetDrop",  &MillingCutter::facetDrop,  &MillingCutter_py::default_facetDrop )
         .def("edgeDrop",   &MillingCutter::edgeDrop,   &MillingCutter_py::default_edgeDrop )
         .def("dropCutter", &MillingCutter::dropCutter)
-        .def("pushCutter", &MillingCutter::pushCutter)
+        .def("pushCutter", static_cast< bool (MillingCutter::*)(const Fiber&, Interval&, const Triangle&) const>(&MillingCutter::pushCutter))
         .def("offsetCutter", &MillingCutter::offsetCutter,  bp::return_value_policy<bp::manage_new_object>() )
         .def("__str__",    &MillingCutter::str, &MillingCutter_py::default_str )
         .def("getRadius", &MillingCutter::getRadius )
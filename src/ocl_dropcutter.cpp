@@ -40,15 +40,30 @@ void export_dropcutter() {
     bp::class_<BatchDropCutter_py, bp::bases<BatchDropCutter> >("BatchDropCutter")
         .def("run", &BatchDropCutter_py::run)
         .def("getCLPoints", &BatchDropCutter_py::getCLPoints_py)
+        .def("getCLPointArray", &BatchDropCutter_py::getCLPointArray)
         .def("setSTL", &BatchDropCutter_py::setSTL)
         .def("setCutter", &BatchDropCutter_py::setCutter)
         .def("setThreads", &BatchDropCutter_py::setThreads)
         .def("getThreads", &BatchDropCutter_py::getThreads)
         .def("appendPoint", &BatchDropCutter_py::appendPoint)
+        .def("appendPoints", &BatchDropCutter_py::appendPoints)
         .def("getTrianglesUnderCutter", &BatchDropCutter_py::getTrianglesUnderCutter)
         .def("getCalls", &BatchDropCutter_py::getCalls)
         .def("getBucketSize", &BatchDropCutter_py::getBucketSize)
         .def("setBucketSize", &BatchDropCutter_py::setBucketSize)
+        .def("getNodes", &BatchDropCutter_py::getNodes)
+        .def("setPacketSize", &BatchDropCutter_py::setPacketSize)
+        .def("getPacketSize", &BatchDropCutter_py::getPacketSize)
+        .def("runCheckpointed", static_cast< bool (BatchDropCutter_py::*)(const std::string&)>(&BatchDropCutter_py::runCheckpointed))
+        .def("runCheckpointed", static_cast< bool (BatchDropCutter_py::*)(const std::string&, const std::string&)>(&BatchDropCutter_py::runCheckpointed))
+        .def("setChunkSize", &BatchDropCutter_py::setChunkSize)
+        .def("getChunkSize", &BatchDropCutter_py::getChunkSize)
+        .def("readResults", &BatchDropCutter_py::readResults_py)
+        .staticmethod("readResults")
+        .def("appendCutter", &BatchDropCutter_py::appendCutter)
+        .def("clearCutters", &BatchDropCutter_py::clearCutters)
+        .def("runCutters", &BatchDropCutter_py::runCutters)
+        .def("getCutterCLPoints", &BatchDropCutter_py::getCutterCLPoints_py)
     ;
 
 
@@ -63,6 +78,11 @@ void export_dropcutter() {
         .def("setPath", &PathDropCutter_py::setPath)
         .def("getZ", &PathDropCutter_py::getZ)
         .def("setZ", &PathDropCutter_py::setZ)
+        .def("setPacketSize", &PathDropCutter_py::setPacketSize)
+        .def("streamRun", &PathDropCutter_py::streamRun_py)
+        .def("setChunkSize", &PathDropCutter_py::setChunkSize)
+        .def("getChunkSize", &PathDropCutter_py::getChunkSize)
+        .def("setFilterTolerance", &PathDropCutter_py::setFilterTolerance)
     ;
     bp::class_<AdaptivePathDropCutter>("AdaptivePathDropCutter_base")
     ;
@@ -78,6 +98,8 @@ void export_dropcutter() {
         .def("setPath", &AdaptivePathDropCutter_py::setPath)
         .def("getZ", &AdaptivePathDropCutter_py::getZ)
         .def("setZ", &AdaptivePathDropCutter_py::setZ)
+        .def("setThreads", &AdaptivePathDropCutter_py::setThreads)
+        .def("getThreads", &AdaptivePathDropCutter_py::getThreads)
     ;
 
 
@@ -116,6 +116,8 @@ void export_geometry() {
     ;
     bp::class_<STLSurf_py, bp::bases<STLSurf> >("STLSurf")
         .def("addTriangle", &STLSurf_py::addTriangle)
+        .def("addTriangles", &STLSurf_py::addTriangles)
+        .def("addMesh", &STLSurf_py::addMesh)
         .def("__str__", &STLSurf_py::str)
         .def("size", &STLSurf_py::size)
         .def("rotate", &STLSurf_py::rotate)
@@ -173,6 +175,7 @@ void export_geometry() {
         .def("getTypeSpanPairs", &Path_py::getTypeSpanPairs)
         .def("append",static_cast< void (Path_py::*)(const Line &l)>(&Path_py::append))
         .def("append",static_cast< void (Path_py::*)(const Arc &a)>(&Path_py::append))
+        .def("appendPolyline", &Path_py::appendPolyline)
     ;
 }
 
@@ -26,12 +26,11 @@
 namespace ocl
 {
 
-int VertexProps::count = 0;
-
 VoronoiDiagram::VoronoiDiagram(double far, unsigned int n_bins) {
     fgrid = new FaceGrid(far, n_bins);
     far_radius=far;
     gen_count=3;
+    vertex_count=0;
     init();
 }
 
@@ -39,6 +38,13 @@ VoronoiDiagram::~VoronoiDiagram() {
     delete fgrid; 
 }
 
+// the vertex indices are counted per diagram, so diagrams on separate threads don't share a counter
+HEVertex VoronoiDiagram::add_vertex(const VertexProps& prop) {
+    HEVertex v = hedi::add_vertex( prop, g );
+    g[v].index = vertex_count++;
+    return v;
+}
+
 // add one vertex at origo and three vertices at 'infinity' and their associated edges
 void VoronoiDiagram::init() {
     //std::cout << "VD init() \n";
@@ -49,10 +55,10 @@ void VoronoiDiagram::init() {
     VertexProps v1prop(Point(0, far_multiplier*far_radius), OUT);
     VertexProps v2prop(Point( cos(-5*PI/6)*far_multiplier*far_radius, sin(-5*PI/6)*far_multiplier*far_radius), OUT);
     VertexProps v3prop(Point( cos(-PI/6)*far_multiplier*far_radius, sin(-PI/6)*far_multiplier*far_radius), OUT);
-    v0  = hedi::add_vertex( v0prop, g );
-    v01 = hedi::add_vertex( v1prop, g );
-    v02 = hedi::add_vertex( v2prop, g );
-    v03 = hedi::add_vertex( v3prop, g );
+    v0  = add_vertex( v0prop );
+    v01 = add_vertex( v1prop );
+    v02 = add_vertex( v2prop );
+    v03 = add_vertex( v3prop );
 
     // the locations of the initial generators:
     double gen_mutliplier = 3;
@@ -70,9 +76,9 @@ void VoronoiDiagram::init() {
     g[e1].face = f1;
     g[e2].face = f1;
     g[e3].face = f1;
-    g[e1].next = e2;
-    g[e2].next = e3;
-    g[e3].next = e1;
+    hedi::set_next( e1, e2, g );
+    hedi::set_next( e2, e3, g );
+    hedi::set_next( e3, e1, g );
     
     // add face 2: v0-v2-v3
     HEEdge e4 = hedi::add_edge( v0, v02  , g );   
@@ -83,9 +89,9 @@ void VoronoiDiagram::init() {
     g[e4].face = f2;
     g[e5].face = f2;
     g[e6].face = f2;
-    g[e4].next = e5;
-    g[e5].next = e6;
-    g[e6].next = e4;
+    hedi::set_next( e4, e5, g );
+    hedi::set_next( e5, e6, g );
+    hedi::set_next( e6, e4, g );
     
     // add face 3: v0-v3-v1 
     HEEdge e7 = hedi::add_edge( v0 , v03 , g);   
@@ -96,9 +102,9 @@ void VoronoiDiagram::init() {
     g[e7].face = f3;
     g[e8].face = f3;
     g[e9].face = f3;
-    g[e7].next = e8;
-    g[e8].next = e9;
-    g[e9].next = e7;
+    hedi::set_next( e7, e8, g );
+    hedi::set_next( e8, e9, g );
+    hedi::set_next( e9, e7, g );
     
     // twin edges
     g[e1].twin = e9;
@@ -190,7 +196,7 @@ void VoronoiDiagram::remove_vertex_set(VertexVector& v0 , HEFace newface) {
             HEVertex out_target = hedi::target( edge , g);
             if ( g[out_target].type == NEW ) { // the next vertex along the face should be "NEW"
                 if ( out_target != current_source ) { // but not where we came from
-                    g[current_edge].next = edge; // this is the edge we want to take
+                    hedi::set_next( current_edge, edge, g ); // this is the edge we want to take
                     
                     // current and next should belong on the same face
                     
@@ -278,15 +284,15 @@ void VoronoiDiagram::split_face(HEFace newface, HEFace f) {
     }
     // now connect new_previous -> new_source -> new_target -> new_next
     HEEdge e_new = hedi::add_edge( new_source, new_target , g); // face,next,twin
-    g[new_previous].next = e_new;
-    g[e_new].next = new_next;
+    hedi::set_next( new_previous, e_new, g );
+    hedi::set_next( e_new, new_next, g );
     g[e_new].face = f;
     g[f].edge = e_new; 
     
     // the twin edge that bounds the new face
     HEEdge e_twin = hedi::add_edge( new_target, new_source , g);
-    g[twin_previous].next = e_twin;
-    g[e_twin].next = twin_next;
+    hedi::set_next( twin_previous, e_twin, g );
+    hedi::set_next( e_twin, twin_next, g );
     g[e_twin].face = newface;
     g[newface].edge = e_twin; 
     
@@ -318,7 +324,7 @@ void VoronoiDiagram::add_new_voronoi_vertices(VertexVector& v0, const Point& p)
     assert( !q_edges.empty() );
     
     for( unsigned int m=0; m<q_edges.size(); ++m )  {  // create new vertices on all edges q_edges[]
-        HEVertex q = hedi::add_vertex(g);
+        HEVertex q = add_vertex( VertexProps() );
         g[q].type = NEW;
         in_vertices.push_back(q);
         HEFace face = g[q_edges[m]].face;     assert(  g[face].type == INCIDENT);
@@ -460,8 +466,7 @@ void VoronoiDiagram::printVertices(VertexVector& q) {
 }
 
 void VoronoiDiagram::pushAdjacentVertices(  HEVertex v , std::queue<HEVertex>& Q) {
-    VertexVector adj_verts = hedi::adjacent_vertices(v,g);
-    BOOST_FOREACH( HEVertex w, adj_verts ) {
+    BOOST_FOREACH( HEVertex w, hedi::adjacent_vertices(v,g) ) {
         if ( g[w].type == UNDECIDED ) {
             if ( !g[w].in_queue ) { 
                 Q.push(w); // push adjacent undecided verts for testing.
@@ -472,9 +477,8 @@ void VoronoiDiagram::pushAdjacentVertices(  HEVertex v , std::queue<HEVertex>& Q
 }
 
 int VoronoiDiagram::adjacentInCount(HEVertex v) {
-    VertexVector adj_v = hedi::adjacent_vertices(v,g);
     int in_count=0;
-    BOOST_FOREACH( HEVertex w, adj_v) {
+    BOOST_FOREACH( HEVertex w, hedi::adjacent_vertices(v,g) ) {
         if ( g[w].type == IN )
             in_count++;
     }
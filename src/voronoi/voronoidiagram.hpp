@@ -44,7 +44,7 @@ class VoronoiDiagramChecker;
 class VoronoiDiagram {
     public:
         /// ctor
-        VoronoiDiagram() {}
+        VoronoiDiagram() : vertex_count(0) {}
         /// create diagram with given far-radius and number of bins
         VoronoiDiagram(double far, unsigned int n_bins);
         /// dtor
@@ -63,6 +63,8 @@ class VoronoiDiagram {
     protected:
         /// initialize the diagram with three generators
         void init();
+        /// add a vertex with properties prop to g, and number it with the next vertex index
+        HEVertex add_vertex(const VertexProps& prop);
         /// among the vertices of f, find the one with the lowest detH value
         HEVertex findSeedVertex(HEFace f, const Point& p);
 
@@ -114,6 +116,8 @@ class VoronoiDiagram {
         Point gen3;
         /// the number of generators
         int gen_count;
+        /// the number of vertices added, the index of the next vertex
+        int vertex_count;
         /// temporary variable for incident faces
         FaceVector incident_faces;
         /// temporary variable for in-vertices, out-vertices that need to be reset
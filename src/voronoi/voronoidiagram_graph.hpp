@@ -42,14 +42,14 @@ struct FaceProps;
 typedef unsigned int HEFace;    
 
 // the type of graph with which we construct the voronoi-diagram
-typedef HEDIGraph<     boost::listS,             // out-edges stored in a std::list
-                       boost::listS,             // vertex set stored here
+typedef HEDIGraph<     arenaS,                   // out-edges stored in the edge array
+                       arenaS,                   // vertex set stored here
                        boost::bidirectionalS,    // bidirectional graph.
                        VertexProps,              // vertex properties
                        EdgeProps,                // edge properties
                        FaceProps,                // face properties
                        boost::no_property,       // graph properties
-                       boost::listS              // edge storage
+                       arenaS                    // edge storage
                        > HEGraph;
 
 typedef boost::graph_traits< HEGraph >::vertex_descriptor  HEVertex;
@@ -85,8 +85,7 @@ struct VertexProps {
         init();
     }
     void init() {
-        index = count;
-        count++;
+        index = -1;
         in_queue = false;
     }
     void reset() {
@@ -179,10 +178,8 @@ struct VertexProps {
 // HE data
     /// the position of the vertex
     Point position;
-    /// index of vertex
+    /// index of vertex, set by VoronoiDiagram::add_vertex()
     int index;
-    /// global vertex count
-    static int count;
 };
 
 /// properties of an edge in the voronoi diagram
@@ -198,6 +195,8 @@ struct EdgeProps {
     }
     /// the next edge, counterclockwise, from this edge
     HEEdge next; 
+    /// the previous edge, set with next by hedi::set_next()
+    HEEdge prev;
     /// the twin edge
     HEEdge twin;
     /// the face to which this edge belongs